@@ -0,0 +1,178 @@
+#include "binary_stream.h"
+#include <godot_cpp/core/class_db.hpp>
+
+using namespace godot;
+
+BinaryStreamCore::BinaryStreamCore() {
+	wbuf = nullptr;
+	rbuf = nullptr;
+	capacity = 0;
+	length = 0;
+	position = 0;
+	error = OK;
+}
+
+BinaryStreamCore::BinaryStreamCore(const PackedByteArray &p_data) {
+	set_data(p_data);
+}
+
+void BinaryStreamCore::set_data(const PackedByteArray &p_data) {
+	data = p_data;
+	// Only read access for now, ptrw() would copy a buffer the caller still shares
+	wbuf = nullptr;
+	rbuf = data.ptr();
+	capacity = data.size();
+	length = capacity;
+	position = 0;
+	error = OK;
+}
+
+PackedByteArray BinaryStreamCore::get_data() {
+	if (capacity != length) {
+		data.resize(length);
+		capacity = length;
+	}
+	// The returned copy shares the buffer, the next write has to get its own through ptrw()
+	wbuf = nullptr;
+	rbuf = data.ptr();
+	return data;
+}
+
+void BinaryStreamCore::clear() {
+	data = PackedByteArray();
+	wbuf = nullptr;
+	rbuf = nullptr;
+	capacity = 0;
+	length = 0;
+	position = 0;
+	error = OK;
+}
+
+void BinaryStreamCore::reserve(int64_t p_bytes) {
+	if (p_bytes > capacity) {
+		_prepare_write(p_bytes);
+	}
+}
+
+void BinaryStreamCore::_prepare_write(int64_t p_end) {
+	if (p_end > capacity) {
+		// Grow at least 2x so a long run of small puts stays amortised O(1)
+		int64_t new_capacity = capacity == 0 ? 512 : capacity * 2;
+		if (new_capacity < p_end) {
+			new_capacity = p_end + (p_end / 4);
+		}
+		data.resize(new_capacity);
+		capacity = new_capacity;
+	}
+	wbuf = data.ptrw();
+	rbuf = wbuf;
+}
+
+void BinaryStreamCore::seek(int64_t p_position) {
+	if (p_position < 0 || p_position > length) {
+		set_error(ERR_INVALID_PARAMETER);
+		return;
+	}
+	position = p_position;
+}
+
+void BinaryStreamCore::put_utf8_string(const String &p_string) {
+	const CharString utf8 = p_string.utf8();
+	const int32_t len = utf8.length();
+	put_s32(len);
+	put_bytes(reinterpret_cast<const uint8_t *>(utf8.get_data()), len);
+}
+
+String BinaryStreamCore::get_utf8_string() {
+	const int32_t len = get_s32();
+	if (len < 0) {
+		set_error(ERR_INVALID_DATA);
+		return String();
+	}
+	const uint8_t *src = read_span(len);
+	if (src == nullptr || len == 0) {
+		return String();
+	}
+	// Decoded straight from the buffer, no slice() copy
+	return String::utf8(reinterpret_cast<const char *>(src), len);
+}
+
+PackedByteArray BinaryStream::get_data_bytes(int64_t p_count) {
+	PackedByteArray result;
+	const uint8_t *src = stream.read_span(p_count);
+	if (src != nullptr && p_count > 0) {
+		result.resize(p_count);
+		memcpy(result.ptrw(), src, p_count);
+	}
+	return result;
+}
+
+PackedInt32Array BinaryStream::get_int32_array(int64_t p_count) {
+	PackedInt32Array result;
+	if (p_count > 0 && p_count <= stream.get_available_bytes() / 4) {
+		result.resize(p_count);
+		// Fails after an earlier error, which should give an empty array like the other gets
+		if (!stream.get_array(result.ptrw(), p_count)) {
+			result.clear();
+		}
+	} else if (p_count != 0) {
+		stream.set_error(ERR_FILE_EOF);
+	}
+	return result;
+}
+
+PackedFloat32Array BinaryStream::get_float32_array(int64_t p_count) {
+	PackedFloat32Array result;
+	if (p_count > 0 && p_count <= stream.get_available_bytes() / 4) {
+		result.resize(p_count);
+		// Fails after an earlier error, which should give an empty array like the other gets
+		if (!stream.get_array(result.ptrw(), p_count)) {
+			result.clear();
+		}
+	} else if (p_count != 0) {
+		stream.set_error(ERR_FILE_EOF);
+	}
+	return result;
+}
+
+void BinaryStream::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_data", "data"), &BinaryStream::set_data);
+	ClassDB::bind_method(D_METHOD("get_data"), &BinaryStream::get_data);
+	ClassDB::bind_method(D_METHOD("clear"), &BinaryStream::clear);
+	ClassDB::bind_method(D_METHOD("reserve", "bytes"), &BinaryStream::reserve);
+	ClassDB::bind_method(D_METHOD("get_size"), &BinaryStream::get_size);
+	ClassDB::bind_method(D_METHOD("get_position"), &BinaryStream::get_position);
+	ClassDB::bind_method(D_METHOD("get_available_bytes"), &BinaryStream::get_available_bytes);
+	ClassDB::bind_method(D_METHOD("seek", "position"), &BinaryStream::seek);
+	ClassDB::bind_method(D_METHOD("get_error"), &BinaryStream::get_error);
+	ClassDB::bind_method(D_METHOD("clear_error"), &BinaryStream::clear_error);
+
+	ClassDB::bind_method(D_METHOD("put_u8", "value"), &BinaryStream::put_u8);
+	ClassDB::bind_method(D_METHOD("put_u16", "value"), &BinaryStream::put_u16);
+	ClassDB::bind_method(D_METHOD("put_u32", "value"), &BinaryStream::put_u32);
+	ClassDB::bind_method(D_METHOD("put_u64", "value"), &BinaryStream::put_u64);
+	ClassDB::bind_method(D_METHOD("put_float", "value"), &BinaryStream::put_float);
+	ClassDB::bind_method(D_METHOD("put_double", "value"), &BinaryStream::put_double);
+	ClassDB::bind_method(D_METHOD("put_varint", "value"), &BinaryStream::put_varint);
+	ClassDB::bind_method(D_METHOD("put_zigzag", "value"), &BinaryStream::put_zigzag);
+	ClassDB::bind_method(D_METHOD("put_utf8_string", "string"), &BinaryStream::put_utf8_string);
+	ClassDB::bind_method(D_METHOD("put_data", "bytes"), &BinaryStream::put_data);
+	ClassDB::bind_method(D_METHOD("put_int32_array", "values"), &BinaryStream::put_int32_array);
+	ClassDB::bind_method(D_METHOD("put_float32_array", "values"), &BinaryStream::put_float32_array);
+
+	ClassDB::bind_method(D_METHOD("get_u8"), &BinaryStream::get_u8);
+	ClassDB::bind_method(D_METHOD("get_u16"), &BinaryStream::get_u16);
+	ClassDB::bind_method(D_METHOD("get_u32"), &BinaryStream::get_u32);
+	ClassDB::bind_method(D_METHOD("get_u64"), &BinaryStream::get_u64);
+	ClassDB::bind_method(D_METHOD("get_s8"), &BinaryStream::get_s8);
+	ClassDB::bind_method(D_METHOD("get_s16"), &BinaryStream::get_s16);
+	ClassDB::bind_method(D_METHOD("get_s32"), &BinaryStream::get_s32);
+	ClassDB::bind_method(D_METHOD("get_float"), &BinaryStream::get_float);
+	ClassDB::bind_method(D_METHOD("get_double"), &BinaryStream::get_double);
+	ClassDB::bind_method(D_METHOD("get_varint"), &BinaryStream::get_varint);
+	ClassDB::bind_method(D_METHOD("get_zigzag"), &BinaryStream::get_zigzag);
+	ClassDB::bind_method(D_METHOD("get_utf8_string"), &BinaryStream::get_utf8_string);
+	ClassDB::bind_method(D_METHOD("get_data_bytes", "count"), &BinaryStream::get_data_bytes);
+	ClassDB::bind_method(D_METHOD("get_int32_array", "count"), &BinaryStream::get_int32_array);
+	ClassDB::bind_method(D_METHOD("get_float32_array", "count"), &BinaryStream::get_float32_array);
+}
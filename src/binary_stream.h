@@ -0,0 +1,332 @@
+#ifndef BINARY_STREAM_H
+#define BINARY_STREAM_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/global_constants.hpp>
+#include <godot_cpp/core/defs.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace godot {
+
+// Little-endian byte stream over a PackedByteArray, used by the save code.
+// Holds on to the buffer's raw ptrw()/ptr() span, so a put or get is a bounds
+// check and a memcpy instead of one encode_*/decode_* call into the engine
+// per field. Reads past the end (or malformed data) set a sticky error, return
+// 0 from then on, and are checked once with get_error() after a whole record.
+class BinaryStreamCore {
+private:
+	PackedByteArray data;
+	uint8_t *wbuf; // data.ptrw(), null until the next write when the buffer may be shared
+	const uint8_t *rbuf; // data.ptr(), valid for reading up to length
+	int64_t capacity; // data.size()
+	int64_t length; // bytes written or loaded, <= capacity
+	int64_t position;
+	Error error;
+
+	void _prepare_write(int64_t p_end);
+
+	inline uint8_t *_write_span(int64_t p_bytes) {
+		const int64_t end = position + p_bytes;
+		if (unlikely(wbuf == nullptr || end > capacity)) {
+			_prepare_write(end);
+		}
+		uint8_t *dst = wbuf + position;
+		position = end;
+		if (end > length) {
+			length = end;
+		}
+		return dst;
+	}
+
+	template <typename T>
+	static inline void _store_le(uint8_t *p_dst, T p_value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		for (size_t i = 0; i < sizeof(T); i++) {
+			p_dst[i] = static_cast<uint8_t>(p_value >> (8 * i));
+		}
+#else
+		memcpy(p_dst, &p_value, sizeof(T));
+#endif
+	}
+
+	template <typename T>
+	static inline T _load_le(const uint8_t *p_src) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		T value = 0;
+		for (size_t i = 0; i < sizeof(T); i++) {
+			value |= static_cast<T>(p_src[i]) << (8 * i);
+		}
+		return value;
+#else
+		T value;
+		memcpy(&value, p_src, sizeof(T));
+		return value;
+#endif
+	}
+
+public:
+	BinaryStreamCore();
+	explicit BinaryStreamCore(const PackedByteArray &p_data);
+
+	// Replaces the contents and rewinds, for reading
+	void set_data(const PackedByteArray &p_data);
+	// Trimmed to the bytes written; the stream keeps sharing the buffer until it is written again
+	PackedByteArray get_data();
+	void clear();
+	// Grows the buffer up front so the following puts never reallocate
+	void reserve(int64_t p_bytes);
+
+	int64_t get_size() const { return length; }
+	int64_t get_position() const { return position; }
+	int64_t get_available_bytes() const { return length - position; }
+	void seek(int64_t p_position);
+
+	Error get_error() const { return error; }
+	bool has_error() const { return error != OK; }
+	void set_error(Error p_error) {
+		if (error == OK) {
+			error = p_error;
+		}
+	}
+	void clear_error() { error = OK; }
+
+	// Next p_bytes bytes for reading in place, or null (and the error set) if there are not enough
+	inline const uint8_t *read_span(int64_t p_bytes) {
+		if (unlikely(error != OK || p_bytes < 0 || p_bytes > length - position)) {
+			set_error(ERR_FILE_EOF);
+			return nullptr;
+		}
+		const uint8_t *src = rbuf + position;
+		position += p_bytes;
+		return src;
+	}
+
+	inline void put_u8(uint8_t p_value) { *_write_span(1) = p_value; }
+	inline void put_u16(uint16_t p_value) { _store_le(_write_span(2), p_value); }
+	inline void put_u32(uint32_t p_value) { _store_le(_write_span(4), p_value); }
+	inline void put_u64(uint64_t p_value) { _store_le(_write_span(8), p_value); }
+	inline void put_s8(int8_t p_value) { put_u8(static_cast<uint8_t>(p_value)); }
+	inline void put_s16(int16_t p_value) { put_u16(static_cast<uint16_t>(p_value)); }
+	inline void put_s32(int32_t p_value) { put_u32(static_cast<uint32_t>(p_value)); }
+	inline void put_s64(int64_t p_value) { put_u64(static_cast<uint64_t>(p_value)); }
+	inline void put_float(float p_value) {
+		uint32_t bits;
+		memcpy(&bits, &p_value, 4);
+		put_u32(bits);
+	}
+	inline void put_double(double p_value) {
+		uint64_t bits;
+		memcpy(&bits, &p_value, 8);
+		put_u64(bits);
+	}
+
+	// LEB128: 7 bits per byte, low bits first, high bit set on all but the last byte
+	inline void put_varint(uint64_t p_value) {
+		if (p_value < 0x80) {
+			put_u8(static_cast<uint8_t>(p_value));
+			return;
+		}
+		uint8_t tmp[10];
+		int n = 0;
+		while (p_value >= 0x80) {
+			tmp[n++] = static_cast<uint8_t>(p_value) | 0x80;
+			p_value >>= 7;
+		}
+		tmp[n++] = static_cast<uint8_t>(p_value);
+		memcpy(_write_span(n), tmp, n);
+	}
+	// Varint of a signed value mapped 0, -1, 1, -2, ... -> 0, 1, 2, 3, ... so small negatives stay short
+	inline void put_zigzag(int64_t p_value) {
+		put_varint((static_cast<uint64_t>(p_value) << 1) ^ static_cast<uint64_t>(p_value >> 63));
+	}
+
+	inline void put_bytes(const uint8_t *p_bytes, int64_t p_len) {
+		if (p_len > 0) {
+			memcpy(_write_span(p_len), p_bytes, p_len);
+		}
+	}
+
+	// Whole array of fixed-size values, one memcpy on little-endian hosts
+	template <typename T>
+	inline void put_array(const T *p_values, int64_t p_count) {
+		if (p_count <= 0) {
+			return;
+		}
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		uint8_t *dst = _write_span(p_count * (int64_t)sizeof(T));
+		const uint8_t *src = reinterpret_cast<const uint8_t *>(p_values);
+		for (int64_t i = 0; i < p_count * (int64_t)sizeof(T); i += sizeof(T)) {
+			for (size_t b = 0; b < sizeof(T); b++) {
+				dst[i + b] = src[i + sizeof(T) - 1 - b];
+			}
+		}
+#else
+		memcpy(_write_span(p_count * (int64_t)sizeof(T)), p_values, p_count * sizeof(T));
+#endif
+	}
+
+	// s32 byte length followed by the UTF-8 bytes, no terminator
+	void put_utf8_string(const String &p_string);
+
+	inline uint8_t get_u8() {
+		const uint8_t *src = read_span(1);
+		return src ? *src : 0;
+	}
+	inline uint16_t get_u16() {
+		const uint8_t *src = read_span(2);
+		return src ? _load_le<uint16_t>(src) : 0;
+	}
+	inline uint32_t get_u32() {
+		const uint8_t *src = read_span(4);
+		return src ? _load_le<uint32_t>(src) : 0;
+	}
+	inline uint64_t get_u64() {
+		const uint8_t *src = read_span(8);
+		return src ? _load_le<uint64_t>(src) : 0;
+	}
+	inline int8_t get_s8() { return static_cast<int8_t>(get_u8()); }
+	inline int16_t get_s16() { return static_cast<int16_t>(get_u16()); }
+	inline int32_t get_s32() { return static_cast<int32_t>(get_u32()); }
+	inline int64_t get_s64() { return static_cast<int64_t>(get_u64()); }
+	inline float get_float() {
+		const uint32_t bits = get_u32();
+		float value;
+		memcpy(&value, &bits, 4);
+		return value;
+	}
+	inline double get_double() {
+		const uint64_t bits = get_u64();
+		double value;
+		memcpy(&value, &bits, 8);
+		return value;
+	}
+
+	inline uint64_t get_varint() {
+		// Fast path: single byte
+		if (likely(error == OK && position < length && rbuf[position] < 0x80)) {
+			return rbuf[position++];
+		}
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			const uint8_t *src = read_span(1);
+			if (src == nullptr) {
+				return 0;
+			}
+			value |= static_cast<uint64_t>(*src & 0x7f) << shift;
+			if ((*src & 0x80) == 0) {
+				return value;
+			}
+		}
+		// More than 10 bytes is not something put_varint writes
+		set_error(ERR_INVALID_DATA);
+		return 0;
+	}
+	inline int64_t get_zigzag() {
+		const uint64_t value = get_varint();
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	inline bool get_bytes(uint8_t *r_bytes, int64_t p_len) {
+		if (p_len <= 0) {
+			return p_len == 0;
+		}
+		const uint8_t *src = read_span(p_len);
+		if (src == nullptr) {
+			return false;
+		}
+		memcpy(r_bytes, src, p_len);
+		return true;
+	}
+
+	template <typename T>
+	inline bool get_array(T *r_values, int64_t p_count) {
+		if (p_count <= 0) {
+			return p_count == 0;
+		}
+		if (p_count > (length - position) / (int64_t)sizeof(T)) {
+			set_error(ERR_FILE_EOF);
+			return false;
+		}
+		const uint8_t *src = read_span(p_count * (int64_t)sizeof(T));
+		if (src == nullptr) {
+			return false;
+		}
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		uint8_t *dst = reinterpret_cast<uint8_t *>(r_values);
+		for (int64_t i = 0; i < p_count * (int64_t)sizeof(T); i += sizeof(T)) {
+			for (size_t b = 0; b < sizeof(T); b++) {
+				dst[i + b] = src[i + sizeof(T) - 1 - b];
+			}
+		}
+#else
+		memcpy(r_values, src, p_count * sizeof(T));
+#endif
+		return true;
+	}
+
+	String get_utf8_string();
+};
+
+// Script-side wrapper around BinaryStreamCore, for the save blobs that are
+// still assembled in GDScript.
+class BinaryStream : public RefCounted {
+	GDCLASS(BinaryStream, RefCounted)
+
+private:
+	BinaryStreamCore stream;
+
+protected:
+	static void _bind_methods();
+
+public:
+	BinaryStreamCore &get_core() { return stream; }
+
+	void set_data(const PackedByteArray &p_data) { stream.set_data(p_data); }
+	PackedByteArray get_data() { return stream.get_data(); }
+	void clear() { stream.clear(); }
+	void reserve(int64_t p_bytes) { stream.reserve(p_bytes); }
+	int64_t get_size() const { return stream.get_size(); }
+	int64_t get_position() const { return stream.get_position(); }
+	int64_t get_available_bytes() const { return stream.get_available_bytes(); }
+	void seek(int64_t p_position) { stream.seek(p_position); }
+	Error get_error() const { return stream.get_error(); }
+	void clear_error() { stream.clear_error(); }
+
+	void put_u8(int64_t p_value) { stream.put_u8(static_cast<uint8_t>(p_value)); }
+	void put_u16(int64_t p_value) { stream.put_u16(static_cast<uint16_t>(p_value)); }
+	void put_u32(int64_t p_value) { stream.put_u32(static_cast<uint32_t>(p_value)); }
+	void put_u64(int64_t p_value) { stream.put_u64(static_cast<uint64_t>(p_value)); }
+	void put_float(double p_value) { stream.put_float(static_cast<float>(p_value)); }
+	void put_double(double p_value) { stream.put_double(p_value); }
+	void put_varint(int64_t p_value) { stream.put_varint(static_cast<uint64_t>(p_value)); }
+	void put_zigzag(int64_t p_value) { stream.put_zigzag(p_value); }
+	void put_utf8_string(const String &p_string) { stream.put_utf8_string(p_string); }
+	void put_data(const PackedByteArray &p_bytes) { stream.put_bytes(p_bytes.ptr(), p_bytes.size()); }
+	void put_int32_array(const PackedInt32Array &p_values) { stream.put_array(p_values.ptr(), p_values.size()); }
+	void put_float32_array(const PackedFloat32Array &p_values) { stream.put_array(p_values.ptr(), p_values.size()); }
+
+	int64_t get_u8() { return stream.get_u8(); }
+	int64_t get_u16() { return stream.get_u16(); }
+	int64_t get_u32() { return stream.get_u32(); }
+	int64_t get_u64() { return static_cast<int64_t>(stream.get_u64()); }
+	int64_t get_s8() { return stream.get_s8(); }
+	int64_t get_s16() { return stream.get_s16(); }
+	int64_t get_s32() { return stream.get_s32(); }
+	double get_float() { return stream.get_float(); }
+	double get_double() { return stream.get_double(); }
+	int64_t get_varint() { return static_cast<int64_t>(stream.get_varint()); }
+	int64_t get_zigzag() { return stream.get_zigzag(); }
+	String get_utf8_string() { return stream.get_utf8_string(); }
+	PackedByteArray get_data_bytes(int64_t p_count);
+	PackedInt32Array get_int32_array(int64_t p_count);
+	PackedFloat32Array get_float32_array(int64_t p_count);
+};
+
+} // namespace godot
+
+#endif // BINARY_STREAM_H
@@ -1,12 +1,17 @@
 #include "example_class.h"
-#include <cstring>
+#include "binary_stream.h"
+#include "voxel_chunk_data.h"
+#include "voxel_stream_codec.h"
+#include <vector>
 
 void OeufSerializer::_bind_methods() {
 	godot::ClassDB::bind_method(D_METHOD("print_type", "variant"), &OeufSerializer::print_type);
 	godot::ClassDB::bind_method(D_METHOD("print_array", "array"), &OeufSerializer::print_array);
 	godot::ClassDB::bind_method(D_METHOD("serialize_array", "array"), &OeufSerializer::serialize_array);
 	godot::ClassDB::bind_method(D_METHOD("serialize_game_data", "savedat"), &OeufSerializer::serialize_game_data);
+	godot::ClassDB::bind_method(D_METHOD("serialize_game_data_chunks", "savedat", "chunks"), &OeufSerializer::serialize_game_data_chunks);
 	godot::ClassDB::bind_method(D_METHOD("deserialize_game_data", "buffer"), &OeufSerializer::deserialize_game_data);
+	godot::ClassDB::bind_method(D_METHOD("deserialize_game_data_packed", "buffer"), &OeufSerializer::deserialize_game_data_packed);
 	godot::ClassDB::bind_method(D_METHOD("create_cube_mesh"), &OeufSerializer::create_cube_mesh);
 }
 
@@ -36,215 +41,53 @@ PackedByteArray OeufSerializer::serialize_array(const TypedArray<Vector3i> &p_ar
 	return p_packed_array;
 }
 
-// Helper for writing to PackedByteArray
-struct BufferWriter {
-	PackedByteArray data;
-	int offset = 0;
-
-	void ensure_space(int p_bytes) {
-		int needed = offset + p_bytes;
-		int current_size = data.size();
-		if (current_size < needed) {
-			// Grow more aggressively - at least 2x or to needed size
-			int new_size = current_size == 0 ? 512 : current_size * 2;
-			if (new_size < needed) {
-				new_size = needed + (needed / 4); // Add 25% headroom
-			}
-			data.resize(new_size);
-		}
-	}
-
-	// Pre-allocate buffer with estimated size to reduce reallocations
-	void reserve(int p_estimated_size) {
-		if (p_estimated_size > 0 && data.size() < p_estimated_size) {
-			data.resize(p_estimated_size);
-		}
-	}
-
-	void put_8(uint8_t p_value) {
-		ensure_space(1);
-		data.encode_u8(offset, p_value);
-		offset += 1;
-	}
-
-	void put_s8(int8_t p_value) {
-		ensure_space(1);
-		// Cast to uint8_t to preserve bit pattern for negative values
-		data.encode_u8(offset, static_cast<uint8_t>(p_value));
-		offset += 1;
-	}
-
-	void put_16(int16_t p_value) {
-		ensure_space(2);
-		data.encode_s16(offset, p_value);
-		offset += 2;
-	}
-
-	void put_32(int32_t p_value) {
-		ensure_space(4);
-		data.encode_s32(offset, p_value);
-		offset += 4;
-	}
-
-	void put_float(float p_value) {
-		ensure_space(4);
-		data.encode_float(offset, p_value);
-		offset += 4;
-	}
-
-	void put_utf8_string(const String &p_string) {
-		PackedByteArray utf8 = p_string.to_utf8_buffer();
-		int len = utf8.size();
-		put_32(len);
-		if (len > 0) {
-			ensure_space(len);
-			// Use direct memory copy for better performance
-			const uint8_t *src = utf8.ptr();
-			uint8_t *dst = data.ptrw() + offset;
-			memcpy(dst, src, len);
-			offset += len;
-		}
-	}
-
-	// Optimized method to write raw bytes directly
-	void put_bytes(const uint8_t *p_bytes, int p_len) {
-		if (p_len > 0) {
-			ensure_space(p_len);
-			uint8_t *dst = data.ptrw() + offset;
-			memcpy(dst, p_bytes, p_len);
-			offset += p_len;
-		}
-	}
-
-	PackedByteArray get_packed_byte_array() {
-		data.resize(offset);
-		return data;
-	}
-};
-
-// Helper for reading from PackedByteArray
-struct BufferReader {
-	PackedByteArray data;
-	int offset = 0;
-
-	BufferReader(const PackedByteArray &p_data) : data(p_data) {}
-
-	uint8_t get_8() {
-		if (offset + 1 > data.size()) return 0;
-		uint8_t v = data.decode_u8(offset);
-		offset += 1;
-		return v;
-	}
-
-	int8_t get_s8() {
-		if (offset + 1 > data.size()) return 0;
-		uint8_t v = data.decode_u8(offset);
-		offset += 1;
-		// Cast back to signed to interpret as two's complement
-		return static_cast<int8_t>(v);
-	}
-
-	int16_t get_16() {
-		if (offset + 2 > data.size()) return 0;
-		int16_t v = data.decode_s16(offset);
-		offset += 2;
-		return v;
-	}
-
-	int32_t get_32() {
-		if (offset + 4 > data.size()) return 0;
-		int32_t v = data.decode_s32(offset);
-		offset += 4;
-		return v;
-	}
-
-	float get_float() {
-		if (offset + 4 > data.size()) return 0.0f;
-		float v = data.decode_float(offset);
-		offset += 4;
-		return v;
-	}
-
-	String get_utf8_string() {
-		int32_t len = get_32();
-		if (len < 0 || offset + len > data.size()) return "";
-		
-		// To decode utf8 string from a slice, we can use get_string_from_utf8 on a slice
-		// Or construct a new PackedByteArray for the slice.
-		// PackedByteArray slice(int64_t p_begin, int64_t p_end = 2147483647) const;
-		PackedByteArray s = data.slice(offset, offset + len);
-		offset += len;
-		return s.get_string_from_utf8();
-	}
-};
-
-PackedByteArray OeufSerializer::serialize_game_data(const Array &p_savedat) const {
-	if (p_savedat.size() != 5) {
-		ERR_PRINT(vformat("serialize_game_data: Invalid savedat array size (expected 5, got %d)", p_savedat.size()));
-		return PackedByteArray();
+// One voxel in the save's position encoding: a signed byte delta from
+// r_last_position when it fits, otherwise the absolute position as s16s
+static inline void write_voxel_position(BinaryStreamCore &writer, Vector3i &r_last_position, const Vector3i &v) {
+	Vector3i delta = v - r_last_position;
+	//if deltas all fit within a signed 8 bit int, we can use that
+	if (delta.x >= -128 && delta.x <= 127 && delta.y >= -128 && delta.y <= 127 && delta.z >= -128 && delta.z <= 127) {
+		writer.put_u8(0);
+		writer.put_s8(static_cast<int8_t>(delta.x));
+		writer.put_s8(static_cast<int8_t>(delta.y));
+		writer.put_s8(static_cast<int8_t>(delta.z));
+	} else {
+		writer.put_u8(1);
+		writer.put_s16(v.x);
+		writer.put_s16(v.y);
+		writer.put_s16(v.z);
 	}
+	r_last_position = v;
+}
 
-	// 0: level_state_data
-	Dictionary level_state_data = p_savedat[0];
-	
-	// Estimate buffer size: version (1) + voxel_count (4) + entities_count (2) + rough estimates
-	Array voxel_data = level_state_data["voxel_data"];
-	Array entities = p_savedat[4];
-	int voxel_count = voxel_data.size();
-	int entities_count = entities.size();
-	
-	// Rough estimate: ~10 bytes per voxel, ~50 bytes per entity, plus overhead
-	int estimated_size = 64 + (voxel_count * 10) + (entities_count * 50);
-	
-	BufferWriter writer;
-	writer.reserve(estimated_size);
-	
-	// version
-	writer.put_8(level_state_data["version"]);
-
-	// voxel_data
-	writer.put_32(voxel_count);
-
-	Vector3i last_position = Vector3i(0, 0, 0);
-	for (int i = 0; i < voxel_count; i++) {
-		Array voxel = voxel_data[i];
-		Vector3i v = voxel[0];
-		Vector3i delta = v - last_position;
-		//if deltas all fit within a signed 8 bit int, we can use that
-		if (delta.x >= -128 && delta.x <= 127 && delta.y >= -128 && delta.y <= 127 && delta.z >= -128 && delta.z <= 127) {
-			writer.put_8(0);
-			writer.put_s8(static_cast<int8_t>(delta.x));
-			writer.put_s8(static_cast<int8_t>(delta.y));
-			writer.put_s8(static_cast<int8_t>(delta.z));
-		} else {
-			writer.put_8(1);
-			writer.put_16(v.x);
-			writer.put_16(v.y);
-			writer.put_16(v.z);
-		}
-		last_position = v;
-		writer.put_8(voxel[1]); // blocktype
-		writer.put_8(voxel[2]); // tx
-		writer.put_8(voxel[3]); // ty
-		//rot goes from 0 to 3, vflip is bool, so encode together
-		int rot = voxel[4];
-		int vflip = voxel[5] ? 1 : 0;
-		writer.put_8(rot + vflip * 4); // combined rot (0-3) + vflip (0-1) * 4
-		writer.put_8(voxel[6]);
-	}
+// Properties of one voxel_data entry [position, blocktype, tx, ty, rot, vflip, layer],
+// truncated to bytes the way the per-voxel records store them
+static inline VoxelData record_from_save_voxel(const Array &voxel) {
+	VoxelData vd;
+	vd.shape_type = static_cast<uint8_t>((int)voxel[1]);
+	vd.tx = static_cast<uint8_t>((int)voxel[2]);
+	vd.ty = static_cast<uint8_t>((int)voxel[3]);
+	vd.rot = static_cast<int8_t>((int)voxel[4] & 3);
+	vd.vflip = voxel[5];
+	vd.layer = static_cast<int8_t>((int)voxel[6]);
+	return vd;
+}
 
+// Everything after the voxels - layers, selected layer, cameras and entities -
+// shared by both save paths
+static void write_level_tail(BinaryStreamCore &writer, const Dictionary &level_state_data, const Array &p_savedat) {
 	// layers
 	Array layers = level_state_data["layers"];
 	int layers_count = layers.size();
-	writer.put_8(layers_count);
+	writer.put_u8(layers_count);
 	for (int i = 0; i < layers_count; i++) {
 		Dictionary layer = layers[i];
 		writer.put_utf8_string(layer["name"]);
-		writer.put_8(layer["visible"]);
+		writer.put_u8(layer["visible"]);
 	}
 
 	// selected_layer_idx
-	writer.put_8(level_state_data["selected_layer_idx"]);
+	writer.put_u8(level_state_data["selected_layer_idx"]);
 
 	// 1: camera_pos
 	Vector3 camera_pos = p_savedat[1];
@@ -265,19 +108,21 @@ PackedByteArray OeufSerializer::serialize_game_data(const Array &p_savedat) cons
 	writer.put_float(camera_rot_rotation.z);
 
 	// 4: entities
-	writer.put_16(entities_count);
+	Array entities = p_savedat[4];
+	int entities_count = entities.size();
+	writer.put_s16(entities_count);
 	for (int i = 0; i < entities_count; i++) {
 		Dictionary entity = entities[i];
 		writer.put_utf8_string(entity["name"]);
 		
 		int32_t entity_type = entity["type"];
-		writer.put_8(entity_type);
+		writer.put_u8(entity_type);
 
 		// Handle position type (Vector3 vs Vector3i)
 		Vector3i pos = entity["position"];
-		writer.put_16(pos.x);
-		writer.put_16(pos.y);
-		writer.put_16(pos.z);
+		writer.put_s16(pos.x);
+		writer.put_s16(pos.y);
+		writer.put_s16(pos.z);
 		
 		// Calculate flags for optional fields first to save space
 		uint8_t flags = 0;
@@ -305,10 +150,10 @@ PackedByteArray OeufSerializer::serialize_game_data(const Array &p_savedat) cons
 		}
 		
 		// Write flags byte, then conditional fields
-		writer.put_8(flags);
+		writer.put_u8(flags);
 		
 		if ((flags & 0x01) != 0) {
-			writer.put_8(static_cast<uint8_t>(dir_value + 1));
+			writer.put_u8(static_cast<uint8_t>(dir_value + 1));
 		}
 		
 		if ((flags & 0x02) != 0) {
@@ -321,72 +166,244 @@ PackedByteArray OeufSerializer::serialize_game_data(const Array &p_savedat) cons
 
 		if (entity_type == 3) {
 			Vector3i size_EDS = entity.has("size_EDS") ? (Vector3i)entity["size_EDS"] : Vector3i();
-			writer.put_16(size_EDS.x);
-			writer.put_16(size_EDS.y);
-			writer.put_16(size_EDS.z);
+			writer.put_s16(size_EDS.x);
+			writer.put_s16(size_EDS.y);
+			writer.put_s16(size_EDS.z);
 
 			Vector3i size_WUN = entity.has("size_WUN") ? (Vector3i)entity["size_WUN"] : Vector3i();
-			writer.put_16(size_WUN.x);
-			writer.put_16(size_WUN.y);
-			writer.put_16(size_WUN.z);
+			writer.put_s16(size_WUN.x);
+			writer.put_s16(size_WUN.y);
+			writer.put_s16(size_WUN.z);
 		}
 	}
-
-	return writer.get_packed_byte_array();
 }
 
-Array OeufSerializer::deserialize_game_data(const PackedByteArray &p_buffer) const {
-	BufferReader reader(p_buffer);
+PackedByteArray OeufSerializer::serialize_game_data(const Array &p_savedat) const {
+	if (p_savedat.size() != 5) {
+		ERR_PRINT(vformat("serialize_game_data: Invalid savedat array size (expected 5, got %d)", p_savedat.size()));
+		return PackedByteArray();
+	}
 
-	// Root array
-	Array savedat;
+	// 0: level_state_data
+	Dictionary level_state_data = p_savedat[0];
 	
-	// 0: level_state_data (Dictionary)
-	Dictionary level_state_data;
+	// Estimate buffer size: version (1) + voxel_count (4) + entities_count (2) + rough estimates
+	Array voxel_data = level_state_data["voxel_data"];
+	Array entities = p_savedat[4];
+	int voxel_count = voxel_data.size();
+	int entities_count = entities.size();
 	
-	// version
-	level_state_data[StringName("version")] = reader.get_8();
+	// Rough estimate: ~10 bytes per voxel, ~50 bytes per entity, plus overhead
+	int estimated_size = 64 + (voxel_count * 10) + (entities_count * 50);
 	
-	// voxel_data
-	TypedArray<Array> voxel_data;
-	int voxel_count = reader.get_32();
-	Vector3i last_position = Vector3i(0, 0, 0);
-	for (int i = 0; i < voxel_count; i++) {
-		Array voxel;
-		uint8_t position_type = reader.get_8();
-		if (position_type == 0) {
-			last_position += Vector3i(reader.get_s8(), reader.get_s8(), reader.get_s8());
+	BinaryStreamCore writer;
+	writer.reserve(estimated_size);
+	
+	// version
+	const int version = level_state_data["version"];
+	writer.put_u8(version);
+
+	if (version >= VoxelStreamCodec::FIRST_SAVE_VERSION) {
+		// voxel_data, sorted and compressed by the codec
+		std::vector<Vector3i> positions(voxel_count);
+		std::vector<VoxelData> records(voxel_count);
+		for (int i = 0; i < voxel_count; i++) {
+			Array voxel = voxel_data[i];
+			positions[i] = voxel[0];
+			records[i] = record_from_save_voxel(voxel);
+		}
+		VoxelStreamCodec::encode(writer, positions.data(), records.data(), voxel_count);
+	} else {
+		// voxel_data
+		writer.put_s32(voxel_count);
+
+		Vector3i last_position = Vector3i(0, 0, 0);
+		for (int i = 0; i < voxel_count; i++) {
+			Array voxel = voxel_data[i];
+			Vector3i v = voxel[0];
+			write_voxel_position(writer, last_position, v);
+			writer.put_u8(voxel[1]); // blocktype
+			writer.put_u8(voxel[2]); // tx
+			writer.put_u8(voxel[3]); // ty
+			//rot goes from 0 to 3, vflip is bool, so encode together
+			int rot = voxel[4];
+			int vflip = voxel[5] ? 1 : 0;
+			writer.put_u8(rot + vflip * 4); // combined rot (0-3) + vflip (0-1) * 4
+			writer.put_u8(voxel[6]);
+		}
+	}
+
+	write_level_tail(writer, level_state_data, p_savedat);
+
+	return writer.get_data();
+}
+
+PackedByteArray OeufSerializer::serialize_game_data_chunks(const Array &p_savedat, const Dictionary &p_chunks) const {
+	if (p_savedat.size() != 5) {
+		ERR_PRINT(vformat("serialize_game_data_chunks: Invalid savedat array size (expected 5, got %d)", p_savedat.size()));
+		return PackedByteArray();
+	}
+
+	// Each chunk is either a VoxelChunkData or [positions (PackedInt32Array of x,y,z), records
+	// (PackedByteArray of VoxelChunkData.PACKED_RECORD_SIZE byte records)]. The voxel count
+	// comes first in the file, so resolve them all before writing.
+	struct ChunkSource {
+		const VoxelChunkData *chunk = nullptr;
+		PackedInt32Array positions;
+		PackedByteArray records;
+		int64_t count = 0;
+	};
+	std::vector<ChunkSource> sources;
+	Array chunk_values = p_chunks.values();
+	sources.resize(chunk_values.size());
+	int64_t voxel_count = 0;
+	for (int64_t i = 0; i < chunk_values.size(); i++) {
+		const Variant &value = chunk_values[i];
+		ChunkSource &src = sources[i];
+		if (value.get_type() == Variant::OBJECT) {
+			Ref<VoxelChunkData> chunk = value;
+			ERR_FAIL_COND_V_MSG(chunk.is_null(), PackedByteArray(), "serialize_game_data_chunks: chunk values must be VoxelChunkData or [positions, records]");
+			src.chunk = chunk.ptr();
+			src.count = chunk->get_voxel_count();
 		} else {
-			last_position = Vector3i(reader.get_16(), reader.get_16(), reader.get_16());
+			Array pair = value;
+			ERR_FAIL_COND_V_MSG(pair.size() != 2, PackedByteArray(), "serialize_game_data_chunks: chunk values must be VoxelChunkData or [positions, records]");
+			src.positions = pair[0];
+			src.records = pair[1];
+			src.count = src.positions.size() / 3;
+			ERR_FAIL_COND_V_MSG(src.records.size() < src.count * VoxelChunkData::PACKED_RECORD_SIZE, PackedByteArray(), vformat("serialize_game_data_chunks: %d positions but only %d record bytes", src.count, src.records.size()));
 		}
+		voxel_count += src.count;
+	}
+	ERR_FAIL_COND_V_MSG(voxel_count > INT32_MAX, PackedByteArray(), "serialize_game_data_chunks: too many voxels");
 
-		voxel.append(last_position);
-		
-		voxel.append(reader.get_8()); // blocktype
-		voxel.append(reader.get_8()); // tx
-		voxel.append(reader.get_8()); // ty
-		uint8_t rot_vflip = reader.get_8();
-		voxel.append(rot_vflip & 3); // rot (bits 0-1)
-		voxel.append((rot_vflip & 4) != 0);  // vflip (bit 2)
-		voxel.append(reader.get_8()); // extra int
-		
-		voxel_data.append(voxel);
+	// 0: level_state_data, without voxel_data
+	Dictionary level_state_data = p_savedat[0];
+	Array entities = p_savedat[4];
+
+	BinaryStreamCore writer;
+	writer.reserve(64 + voxel_count * 10 + entities.size() * 50);
+
+	// Every voxel of every chunk, in map order
+	auto for_each_voxel = [&sources](auto &&p_visit) {
+		for (const ChunkSource &src : sources) {
+			const Vector3i *chunk_positions = src.chunk ? src.chunk->get_positions_ptr() : nullptr;
+			const VoxelData *chunk_records = src.chunk ? src.chunk->get_records_ptr() : nullptr;
+			const int32_t *packed_positions = src.positions.ptr();
+			const uint8_t *packed_records = src.records.ptr();
+			for (int64_t i = 0; i < src.count; i++) {
+				if (src.chunk) {
+					p_visit(chunk_positions[i], chunk_records[i]);
+				} else {
+					p_visit(Vector3i(packed_positions[i * 3], packed_positions[i * 3 + 1], packed_positions[i * 3 + 2]),
+							VoxelChunkData::decode_record(packed_records + i * VoxelChunkData::PACKED_RECORD_SIZE));
+				}
+			}
+		}
+	};
+
+	// version
+	const int version = level_state_data["version"];
+	writer.put_u8(version);
+
+	if (version >= VoxelStreamCodec::FIRST_SAVE_VERSION) {
+		std::vector<Vector3i> positions;
+		std::vector<VoxelData> records;
+		positions.reserve(voxel_count);
+		records.reserve(voxel_count);
+		for_each_voxel([&](const Vector3i &v, const VoxelData &vd) {
+			positions.push_back(v);
+			records.push_back(vd);
+		});
+		VoxelStreamCodec::encode(writer, positions.data(), records.data(), voxel_count);
+	} else {
+		// voxel_data, in the same record format as serialize_game_data
+		writer.put_s32((int32_t)voxel_count);
+		Vector3i last_position = Vector3i(0, 0, 0);
+		for_each_voxel([&](const Vector3i &v, const VoxelData &vd) {
+			write_voxel_position(writer, last_position, v);
+			writer.put_u8(vd.shape_type); // blocktype
+			writer.put_u8(static_cast<uint8_t>(vd.tx));
+			writer.put_u8(static_cast<uint8_t>(vd.ty));
+			writer.put_u8(vd.rot + (vd.vflip ? 4 : 0)); // combined rot (0-3) + vflip (0-1) * 4
+			writer.put_u8(static_cast<uint8_t>(vd.layer));
+		});
 	}
-	level_state_data[StringName("voxel_data")] = voxel_data;
-	
+
+	write_level_tail(writer, level_state_data, p_savedat);
+
+	return writer.get_data();
+}
+
+// One voxel: position (delta from r_last_position or absolute), then
+// blocktype, tx, ty, rot|vflip and layer
+static inline void read_voxel(BinaryStreamCore &p_reader, Vector3i &r_last_position, VoxelData &r_record) {
+	uint8_t position_type = p_reader.get_u8();
+	if (position_type == 0) {
+		// Separate statements, argument evaluation order is unspecified
+		const int dx = p_reader.get_s8();
+		const int dy = p_reader.get_s8();
+		const int dz = p_reader.get_s8();
+		r_last_position += Vector3i(dx, dy, dz);
+	} else {
+		const int x = p_reader.get_s16();
+		const int y = p_reader.get_s16();
+		const int z = p_reader.get_s16();
+		r_last_position = Vector3i(x, y, z);
+	}
+
+	r_record.shape_type = p_reader.get_u8(); // blocktype
+	r_record.tx = p_reader.get_u8();
+	r_record.ty = p_reader.get_u8();
+	uint8_t rot_vflip = p_reader.get_u8();
+	r_record.rot = rot_vflip & 3; // rot (bits 0-1)
+	r_record.vflip = (rot_vflip & 4) != 0; // vflip (bit 2)
+	r_record.layer = (int8_t)p_reader.get_u8(); // extra int
+}
+
+// Version byte and the voxels in whichever encoding that version uses, into
+// native arrays for both load paths. False when the voxel section is corrupt.
+static bool read_voxel_section(BinaryStreamCore &p_reader, Dictionary &r_level_state_data, std::vector<Vector3i> &r_positions, std::vector<VoxelData> &r_records) {
+	// version
+	const int version = p_reader.get_u8();
+	r_level_state_data[StringName("version")] = version;
+
+	if (version >= VoxelStreamCodec::FIRST_SAVE_VERSION) {
+		return VoxelStreamCodec::decode(p_reader, r_positions, r_records);
+	}
+
+	int voxel_count = p_reader.get_s32();
+	// Smallest voxel record is 9 bytes, anything claiming more than that is a corrupt count
+	if (voxel_count < 0 || (int64_t)voxel_count * 9 > p_reader.get_available_bytes()) {
+		p_reader.set_error(ERR_INVALID_DATA);
+		return false;
+	}
+	r_positions.resize(voxel_count);
+	r_records.resize(voxel_count);
+	Vector3i last_position = Vector3i(0, 0, 0);
+	for (int i = 0; i < voxel_count; i++) {
+		read_voxel(p_reader, last_position, r_records[i]);
+		r_positions[i] = last_position;
+	}
+	return !p_reader.has_error();
+}
+
+// Everything after the voxels - layers, selected layer, cameras and entities -
+// appended to savedat after level_state_data
+static void read_level_tail(BinaryStreamCore &reader, Dictionary &level_state_data, Array &savedat) {
 	// layers
 	Array layers;
-	int layers_count = reader.get_8();
+	int layers_count = reader.get_u8();
 	for (int i = 0; i < layers_count; i++) {
 		Dictionary layer;
 		layer[StringName("name")] = reader.get_utf8_string();
-		layer[StringName("visible")] = reader.get_8() != 0;
+		layer[StringName("visible")] = reader.get_u8() != 0;
 		layers.append(layer);
 	}
 	level_state_data[StringName("layers")] = layers;
 	
 	// selected_layer_idx
-	level_state_data[StringName("selected_layer_idx")] = reader.get_8();
+	level_state_data[StringName("selected_layer_idx")] = reader.get_u8();
 	
 	savedat.append(level_state_data);
 	
@@ -413,25 +430,25 @@ Array OeufSerializer::deserialize_game_data(const PackedByteArray &p_buffer) con
 	
 	// 4: entities
 	TypedArray<Dictionary> entities;
-	int entities_count = reader.get_16();
+	int entities_count = reader.get_u16();
 	for (int i = 0; i < entities_count; i++) {
 		Dictionary entity;
 		entity[StringName("name")] = reader.get_utf8_string();
-		int32_t entity_type = reader.get_8();
+		int32_t entity_type = reader.get_u8();
 		entity[StringName("type")] = entity_type;
 
 		Vector3i pos;
-		pos.x = reader.get_16();
-		pos.y = reader.get_16();
-		pos.z = reader.get_16();
+		pos.x = reader.get_s16();
+		pos.y = reader.get_s16();
+		pos.z = reader.get_s16();
 		entity[StringName("position")] = pos;
 		
 		// Read flags byte for optional fields
-		uint8_t flags = reader.get_8();
+		uint8_t flags = reader.get_u8();
 		
 		if ((flags & 0x01) != 0) {
 			// Has dir
-			int dir = reader.get_8();
+			int dir = reader.get_u8();
 			entity[StringName("dir")] = dir - 1;
 		}
 		
@@ -447,21 +464,104 @@ Array OeufSerializer::deserialize_game_data(const PackedByteArray &p_buffer) con
 		
 		if (entity_type == 3) {
 			Vector3i size_EDS;
-			size_EDS.x = reader.get_16();
-			size_EDS.y = reader.get_16();
-			size_EDS.z = reader.get_16();
+			size_EDS.x = reader.get_s16();
+			size_EDS.y = reader.get_s16();
+			size_EDS.z = reader.get_s16();
 			entity[StringName("size_EDS")] = size_EDS;
 
 			Vector3i size_WUN;
-			size_WUN.x = reader.get_16();
-			size_WUN.y = reader.get_16();
-			size_WUN.z = reader.get_16();
+			size_WUN.x = reader.get_s16();
+			size_WUN.y = reader.get_s16();
+			size_WUN.z = reader.get_s16();
 			entity[StringName("size_WUN")] = size_WUN;
 		}
 
 		entities.append(entity);
 	}
 	savedat.append(entities);
+}
+
+Array OeufSerializer::deserialize_game_data(const PackedByteArray &p_buffer) const {
+	BinaryStreamCore reader(p_buffer);
+
+	// Root array
+	Array savedat;
+	
+	// 0: level_state_data (Dictionary)
+	Dictionary level_state_data;
+	
+	// voxel_data
+	std::vector<Vector3i> positions;
+	std::vector<VoxelData> records;
+	if (!read_voxel_section(reader, level_state_data, positions, records)) {
+		ERR_PRINT(vformat("deserialize_game_data: Corrupt voxel section (error %d at byte %d)", reader.get_error(), reader.get_position()));
+		return Array();
+	}
+	const int voxel_count = (int)positions.size();
+	TypedArray<Array> voxel_data;
+	voxel_data.resize(voxel_count);
+	for (int i = 0; i < voxel_count; i++) {
+		const VoxelData &vd = records[i];
+
+		Array voxel;
+		voxel.resize(7);
+		voxel[0] = positions[i];
+		voxel[1] = vd.shape_type; // blocktype
+		voxel[2] = vd.tx;
+		voxel[3] = vd.ty;
+		voxel[4] = vd.rot;
+		voxel[5] = vd.vflip;
+		voxel[6] = (uint8_t)vd.layer; // extra int, unsigned like the byte on disk
+		voxel_data[i] = voxel;
+	}
+	level_state_data[StringName("voxel_data")] = voxel_data;
+
+	read_level_tail(reader, level_state_data, savedat);
+
+	if (reader.has_error()) {
+		ERR_PRINT(vformat("deserialize_game_data: Truncated or corrupt buffer (error %d at byte %d)", reader.get_error(), reader.get_position()));
+		return Array();
+	}
+
+	return savedat;
+}
+
+Array OeufSerializer::deserialize_game_data_packed(const PackedByteArray &p_buffer) const {
+	BinaryStreamCore reader(p_buffer);
+	Array savedat;
+	Dictionary level_state_data;
+
+	std::vector<Vector3i> voxel_positions;
+	std::vector<VoxelData> voxel_records;
+	if (!read_voxel_section(reader, level_state_data, voxel_positions, voxel_records)) {
+		ERR_PRINT(vformat("deserialize_game_data_packed: Corrupt voxel section (error %d at byte %d)", reader.get_error(), reader.get_position()));
+		return Array();
+	}
+	const int voxel_count = (int)voxel_positions.size();
+
+	// Into two flat buffers instead of one Array per voxel
+	PackedInt32Array positions;
+	PackedByteArray records;
+	positions.resize((int64_t)voxel_count * 3);
+	records.resize((int64_t)voxel_count * VoxelChunkData::PACKED_RECORD_SIZE);
+	int32_t *pos_out = positions.ptrw();
+	uint8_t *rec_out = records.ptrw();
+	for (int i = 0; i < voxel_count; i++) {
+		pos_out[i * 3] = voxel_positions[i].x;
+		pos_out[i * 3 + 1] = voxel_positions[i].y;
+		pos_out[i * 3 + 2] = voxel_positions[i].z;
+		VoxelChunkData::encode_record(voxel_records[i], rec_out + (int64_t)i * VoxelChunkData::PACKED_RECORD_SIZE);
+	}
+	level_state_data[StringName("voxel_count")] = voxel_count;
+	level_state_data[StringName("voxel_positions")] = positions;
+	level_state_data[StringName("voxel_records")] = records;
+
+	read_level_tail(reader, level_state_data, savedat);
+
+	if (reader.has_error()) {
+		ERR_PRINT(vformat("deserialize_game_data_packed: Truncated or corrupt buffer (error %d at byte %d)", reader.get_error(), reader.get_position()));
+		return Array();
+	}
 
 	return savedat;
 }
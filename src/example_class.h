@@ -28,6 +28,15 @@ public:
 	void print_array(const TypedArray<Vector3i> &p_array) const;
 	PackedByteArray serialize_array(const TypedArray<Vector3i> &p_array) const;
 	PackedByteArray serialize_game_data(const Array &p_savedat) const;
+	// serialize_game_data with the voxels taken from chunk storage instead of
+	// level_state_data["voxel_data"]: chunks maps chunk_coord to a VoxelChunkData or
+	// to [positions, records] as in deserialize_game_data_packed. Same output format.
+	PackedByteArray serialize_game_data_chunks(const Array &p_savedat, const Dictionary &p_chunks) const;
 	Array deserialize_game_data(const PackedByteArray &p_buffer) const;
+	// Same as deserialize_game_data, but level_state_data holds voxel_count,
+	// voxel_positions (PackedInt32Array of x,y,z) and voxel_records (PackedByteArray
+	// of VoxelChunkData.PACKED_RECORD_SIZE byte records) instead of voxel_data,
+	// ready for VoxelChunkData.split_packed_voxels()
+	Array deserialize_game_data_packed(const PackedByteArray &p_buffer) const;
 	Ref<Mesh> create_cube_mesh() const;
 };
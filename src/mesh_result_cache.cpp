@@ -0,0 +1,70 @@
+#include "mesh_result_cache.h"
+
+using namespace godot;
+
+MeshResultCache::MeshResultCache() {
+	memory_usage = 0;
+	memory_limit = 32 * 1024 * 1024;
+	hits = 0;
+	misses = 0;
+}
+
+bool MeshResultCache::lookup(uint64_t p_hash, const Vector3i &p_chunk_coord, int p_voxel_count, Dictionary &r_result) {
+	if (memory_limit == 0) {
+		return false;
+	}
+	auto it = entries.find(p_hash);
+	if (it == entries.end() || it->second.chunk_coord != p_chunk_coord || it->second.voxel_count != p_voxel_count) {
+		misses++;
+		return false;
+	}
+	lru.splice(lru.begin(), lru, it->second.lru_it);
+	// Callers may edit the Dictionary they get back (erase keys, add cell_size, ...)
+	r_result = it->second.result.duplicate();
+	hits++;
+	return true;
+}
+
+void MeshResultCache::insert(uint64_t p_hash, const Vector3i &p_chunk_coord, int p_voxel_count, const Dictionary &p_result, size_t p_bytes) {
+	if (memory_limit == 0 || p_bytes > memory_limit) {
+		return;
+	}
+	auto it = entries.find(p_hash);
+	if (it != entries.end()) {
+		memory_usage -= it->second.bytes;
+		lru.erase(it->second.lru_it);
+		entries.erase(it);
+	}
+
+	lru.push_front(p_hash);
+	Entry &entry = entries[p_hash];
+	entry.result = p_result.duplicate();
+	entry.chunk_coord = p_chunk_coord;
+	entry.voxel_count = p_voxel_count;
+	entry.bytes = p_bytes;
+	entry.lru_it = lru.begin();
+	memory_usage += p_bytes;
+	_evict();
+}
+
+void MeshResultCache::_evict() {
+	while (memory_usage > memory_limit && !lru.empty()) {
+		auto it = entries.find(lru.back());
+		memory_usage -= it->second.bytes;
+		entries.erase(it);
+		lru.pop_back();
+	}
+}
+
+void MeshResultCache::clear() {
+	entries.clear();
+	lru.clear();
+	memory_usage = 0;
+	hits = 0;
+	misses = 0;
+}
+
+void MeshResultCache::set_memory_limit(size_t p_bytes) {
+	memory_limit = p_bytes;
+	_evict();
+}
@@ -0,0 +1,56 @@
+#ifndef MESH_RESULT_CACHE_H
+#define MESH_RESULT_CACHE_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace godot {
+
+// LRU of finished chunk results (the Dictionary generate_chunk_mesh returns),
+// keyed by a hash of everything that goes into meshing a chunk. Regenerating
+// an unchanged chunk - mode switches, regen_all_chunks, undo/redo - then hands
+// back the previous ArrayMesh without meshing. Main thread only.
+// Results are copied in and out (shallow, the ArrayMesh itself is shared), so
+// the caller owns the Dictionary it passes or gets back.
+class MeshResultCache {
+private:
+	struct Entry {
+		Dictionary result;
+		Vector3i chunk_coord; // cheap guard against hash collisions
+		int voxel_count;
+		size_t bytes;
+		std::list<uint64_t>::iterator lru_it;
+	};
+
+	std::unordered_map<uint64_t, Entry> entries;
+	std::list<uint64_t> lru; // front = most recently used
+	size_t memory_usage;
+	size_t memory_limit;
+	uint64_t hits;
+	uint64_t misses;
+
+	void _evict();
+
+public:
+	MeshResultCache();
+
+	// Fills r_result and returns true on a hit
+	bool lookup(uint64_t p_hash, const Vector3i &p_chunk_coord, int p_voxel_count, Dictionary &r_result);
+	void insert(uint64_t p_hash, const Vector3i &p_chunk_coord, int p_voxel_count, const Dictionary &p_result, size_t p_bytes);
+
+	void clear();
+	void set_memory_limit(size_t p_bytes);
+	size_t get_memory_limit() const { return memory_limit; }
+	size_t get_memory_usage() const { return memory_usage; }
+	size_t get_entry_count() const { return entries.size(); }
+	uint64_t get_hits() const { return hits; }
+	uint64_t get_misses() const { return misses; }
+};
+
+} // namespace godot
+
+#endif // MESH_RESULT_CACHE_H
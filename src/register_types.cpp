@@ -5,8 +5,12 @@
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
 
+#include "binary_stream.h"
 #include "example_class.h"
+#include "voxel_chunk_data.h"
 #include "voxel_mesher.h"
+#include "voxel_remesh_queue.h"
+#include "voxel_save_archive.h"
 
 using namespace godot;
 
@@ -15,8 +19,12 @@ void initialize_gdextension_types(ModuleInitializationLevel p_level)
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+	GDREGISTER_CLASS(BinaryStream);
 	GDREGISTER_CLASS(OeufSerializer);
+	GDREGISTER_CLASS(VoxelChunkData);
 	GDREGISTER_CLASS(VoxelMesher);
+	GDREGISTER_CLASS(VoxelRemeshQueue);
+	GDREGISTER_CLASS(VoxelSaveArchive);
 }
 
 void uninitialize_gdextension_types(ModuleInitializationLevel p_level) {
@@ -0,0 +1,356 @@
+#include "value_noise.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VALUE_NOISE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang need per-function target attributes to use intrinsics above the
+// baseline ISA; MSVC accepts them anywhere. fma is deliberately not enabled so
+// the compiler cannot contract the scalar and SIMD paths differently.
+#if defined(VALUE_NOISE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define VALUE_NOISE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VALUE_NOISE_TARGET(isa)
+#endif
+
+using namespace godot;
+
+namespace {
+
+// Constants straight from FastNoiseLite
+const uint32_t PRIME_X = 501125321u;
+const uint32_t PRIME_Y = 1136930381u;
+const uint32_t PRIME_Z = 1720413743u;
+const uint32_t HASH_MUL = 0x27d4eb2du;
+const float HASH_SCALE = 1.0f / 2147483648.0f;
+const float LACUNARITY = 2.0f;
+const float GAIN = 0.5f;
+
+// Integer maths is done unsigned so the wrap-around FastNoiseLite relies on is defined
+
+inline int32_t fast_floor(float f) {
+	return f >= 0 ? (int32_t)f : (int32_t)f - 1;
+}
+
+inline float interp_hermite(float t) {
+	return t * t * (3 - 2 * t);
+}
+
+inline float lerp(float a, float b, float t) {
+	return a + t * (b - a);
+}
+
+inline float val_coord(uint32_t seed, uint32_t x_primed, uint32_t y_primed, uint32_t z_primed) {
+	uint32_t hash = seed ^ x_primed ^ y_primed ^ z_primed;
+	hash *= hash * HASH_MUL;
+	return (float)(int32_t)hash * HASH_SCALE;
+}
+
+inline float single_value(uint32_t seed, float x, float y, float z) {
+	const int32_t x1 = fast_floor(x);
+	const int32_t y1 = fast_floor(y);
+	const int32_t z1 = fast_floor(z);
+
+	const float xs = interp_hermite(x - (float)x1);
+	const float ys = interp_hermite(y - (float)y1);
+	const float zs = interp_hermite(z - (float)z1);
+
+	const uint32_t x0p = (uint32_t)x1 * PRIME_X;
+	const uint32_t y0p = (uint32_t)y1 * PRIME_Y;
+	const uint32_t z0p = (uint32_t)z1 * PRIME_Z;
+	const uint32_t x1p = x0p + PRIME_X;
+	const uint32_t y1p = y0p + PRIME_Y;
+	const uint32_t z1p = z0p + PRIME_Z;
+
+	const float xf00 = lerp(val_coord(seed, x0p, y0p, z0p), val_coord(seed, x1p, y0p, z0p), xs);
+	const float xf10 = lerp(val_coord(seed, x0p, y1p, z0p), val_coord(seed, x1p, y1p, z0p), xs);
+	const float xf01 = lerp(val_coord(seed, x0p, y0p, z1p), val_coord(seed, x1p, y0p, z1p), xs);
+	const float xf11 = lerp(val_coord(seed, x0p, y1p, z1p), val_coord(seed, x1p, y1p, z1p), xs);
+
+	const float yf0 = lerp(xf00, xf10, ys);
+	const float yf1 = lerp(xf01, xf11, ys);
+
+	return lerp(yf0, yf1, zs);
+}
+
+// FBm amplitude per octave. FastNoiseLite also multiplies by
+// lerp(1, ..., weighted_strength), which is exactly 1 at the default strength of 0.
+struct OctaveAmps {
+	float amp[ValueNoise::OCTAVES];
+
+	explicit OctaveAmps(float bounding) {
+		float a = bounding;
+		for (int i = 0; i < ValueNoise::OCTAVES; i++) {
+			amp[i] = a;
+			a *= GAIN;
+		}
+	}
+};
+
+typedef void (*BatchKernel)(uint32_t seed, float frequency, const OctaveAmps &amps,
+		const float *x, const float *y, const float *z, float *r_out, int start, int count);
+
+void batch_scalar(uint32_t seed, float frequency, const OctaveAmps &amps,
+		const float *x, const float *y, const float *z, float *r_out, int start, int count) {
+	for (int i = start; i < count; i++) {
+		float px = x[i] * frequency;
+		float py = y[i] * frequency;
+		float pz = z[i] * frequency;
+		float sum = 0;
+		for (int o = 0; o < ValueNoise::OCTAVES; o++) {
+			sum += single_value(seed + (uint32_t)o, px, py, pz) * amps.amp[o];
+			px *= LACUNARITY;
+			py *= LACUNARITY;
+			pz *= LACUNARITY;
+		}
+		r_out[i] = sum;
+	}
+}
+
+#ifdef VALUE_NOISE_X86
+
+VALUE_NOISE_TARGET("sse4.1")
+inline __m128 val_coord_sse(__m128i seed, __m128i xp, __m128i yp, __m128i zp, __m128 scale) {
+	__m128i hash = _mm_xor_si128(_mm_xor_si128(seed, xp), _mm_xor_si128(yp, zp));
+	hash = _mm_mullo_epi32(hash, _mm_mullo_epi32(hash, _mm_set1_epi32((int32_t)HASH_MUL)));
+	return _mm_mul_ps(_mm_cvtepi32_ps(hash), scale);
+}
+
+VALUE_NOISE_TARGET("sse4.1")
+inline __m128 lerp_sse(__m128 a, __m128 b, __m128 t) {
+	return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+VALUE_NOISE_TARGET("sse4.1")
+void batch_sse41(uint32_t seed, float frequency, const OctaveAmps &amps,
+		const float *x, const float *y, const float *z, float *r_out, int start, int count) {
+	const __m128 freq = _mm_set1_ps(frequency);
+	const __m128 lacunarity = _mm_set1_ps(LACUNARITY);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 three = _mm_set1_ps(3.0f);
+	const __m128 scale = _mm_set1_ps(HASH_SCALE);
+	const __m128i prime_x = _mm_set1_epi32((int32_t)PRIME_X);
+	const __m128i prime_y = _mm_set1_epi32((int32_t)PRIME_Y);
+	const __m128i prime_z = _mm_set1_epi32((int32_t)PRIME_Z);
+
+	int i = start;
+	for (; i + 4 <= count; i += 4) {
+		__m128 px = _mm_mul_ps(_mm_loadu_ps(x + i), freq);
+		__m128 py = _mm_mul_ps(_mm_loadu_ps(y + i), freq);
+		__m128 pz = _mm_mul_ps(_mm_loadu_ps(z + i), freq);
+		__m128 sum = zero;
+
+		for (int o = 0; o < ValueNoise::OCTAVES; o++) {
+			const __m128i s = _mm_set1_epi32((int32_t)(seed + (uint32_t)o));
+
+			// fast_floor: truncate, then subtract one for negative inputs (the compare mask is -1)
+			const __m128i ix = _mm_add_epi32(_mm_cvttps_epi32(px), _mm_castps_si128(_mm_cmplt_ps(px, zero)));
+			const __m128i iy = _mm_add_epi32(_mm_cvttps_epi32(py), _mm_castps_si128(_mm_cmplt_ps(py, zero)));
+			const __m128i iz = _mm_add_epi32(_mm_cvttps_epi32(pz), _mm_castps_si128(_mm_cmplt_ps(pz, zero)));
+
+			__m128 xs = _mm_sub_ps(px, _mm_cvtepi32_ps(ix));
+			__m128 ys = _mm_sub_ps(py, _mm_cvtepi32_ps(iy));
+			__m128 zs = _mm_sub_ps(pz, _mm_cvtepi32_ps(iz));
+			xs = _mm_mul_ps(_mm_mul_ps(xs, xs), _mm_sub_ps(three, _mm_mul_ps(two, xs)));
+			ys = _mm_mul_ps(_mm_mul_ps(ys, ys), _mm_sub_ps(three, _mm_mul_ps(two, ys)));
+			zs = _mm_mul_ps(_mm_mul_ps(zs, zs), _mm_sub_ps(three, _mm_mul_ps(two, zs)));
+
+			const __m128i x0p = _mm_mullo_epi32(ix, prime_x);
+			const __m128i y0p = _mm_mullo_epi32(iy, prime_y);
+			const __m128i z0p = _mm_mullo_epi32(iz, prime_z);
+			const __m128i x1p = _mm_add_epi32(x0p, prime_x);
+			const __m128i y1p = _mm_add_epi32(y0p, prime_y);
+			const __m128i z1p = _mm_add_epi32(z0p, prime_z);
+
+			const __m128 xf00 = lerp_sse(val_coord_sse(s, x0p, y0p, z0p, scale), val_coord_sse(s, x1p, y0p, z0p, scale), xs);
+			const __m128 xf10 = lerp_sse(val_coord_sse(s, x0p, y1p, z0p, scale), val_coord_sse(s, x1p, y1p, z0p, scale), xs);
+			const __m128 xf01 = lerp_sse(val_coord_sse(s, x0p, y0p, z1p, scale), val_coord_sse(s, x1p, y0p, z1p, scale), xs);
+			const __m128 xf11 = lerp_sse(val_coord_sse(s, x0p, y1p, z1p, scale), val_coord_sse(s, x1p, y1p, z1p, scale), xs);
+			const __m128 noise = lerp_sse(lerp_sse(xf00, xf10, ys), lerp_sse(xf01, xf11, ys), zs);
+
+			sum = _mm_add_ps(sum, _mm_mul_ps(noise, _mm_set1_ps(amps.amp[o])));
+			px = _mm_mul_ps(px, lacunarity);
+			py = _mm_mul_ps(py, lacunarity);
+			pz = _mm_mul_ps(pz, lacunarity);
+		}
+		_mm_storeu_ps(r_out + i, sum);
+	}
+	batch_scalar(seed, frequency, amps, x, y, z, r_out, i, count);
+}
+
+VALUE_NOISE_TARGET("avx2")
+inline __m256 val_coord_avx2(__m256i seed, __m256i xp, __m256i yp, __m256i zp, __m256 scale) {
+	__m256i hash = _mm256_xor_si256(_mm256_xor_si256(seed, xp), _mm256_xor_si256(yp, zp));
+	hash = _mm256_mullo_epi32(hash, _mm256_mullo_epi32(hash, _mm256_set1_epi32((int32_t)HASH_MUL)));
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(hash), scale);
+}
+
+VALUE_NOISE_TARGET("avx2")
+inline __m256 lerp_avx2(__m256 a, __m256 b, __m256 t) {
+	return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+VALUE_NOISE_TARGET("avx2")
+void batch_avx2(uint32_t seed, float frequency, const OctaveAmps &amps,
+		const float *x, const float *y, const float *z, float *r_out, int start, int count) {
+	const __m256 freq = _mm256_set1_ps(frequency);
+	const __m256 lacunarity = _mm256_set1_ps(LACUNARITY);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 two = _mm256_set1_ps(2.0f);
+	const __m256 three = _mm256_set1_ps(3.0f);
+	const __m256 scale = _mm256_set1_ps(HASH_SCALE);
+	const __m256i prime_x = _mm256_set1_epi32((int32_t)PRIME_X);
+	const __m256i prime_y = _mm256_set1_epi32((int32_t)PRIME_Y);
+	const __m256i prime_z = _mm256_set1_epi32((int32_t)PRIME_Z);
+
+	int i = start;
+	for (; i + 8 <= count; i += 8) {
+		__m256 px = _mm256_mul_ps(_mm256_loadu_ps(x + i), freq);
+		__m256 py = _mm256_mul_ps(_mm256_loadu_ps(y + i), freq);
+		__m256 pz = _mm256_mul_ps(_mm256_loadu_ps(z + i), freq);
+		__m256 sum = zero;
+
+		for (int o = 0; o < ValueNoise::OCTAVES; o++) {
+			const __m256i s = _mm256_set1_epi32((int32_t)(seed + (uint32_t)o));
+
+			const __m256i ix = _mm256_add_epi32(_mm256_cvttps_epi32(px), _mm256_castps_si256(_mm256_cmp_ps(px, zero, _CMP_LT_OQ)));
+			const __m256i iy = _mm256_add_epi32(_mm256_cvttps_epi32(py), _mm256_castps_si256(_mm256_cmp_ps(py, zero, _CMP_LT_OQ)));
+			const __m256i iz = _mm256_add_epi32(_mm256_cvttps_epi32(pz), _mm256_castps_si256(_mm256_cmp_ps(pz, zero, _CMP_LT_OQ)));
+
+			__m256 xs = _mm256_sub_ps(px, _mm256_cvtepi32_ps(ix));
+			__m256 ys = _mm256_sub_ps(py, _mm256_cvtepi32_ps(iy));
+			__m256 zs = _mm256_sub_ps(pz, _mm256_cvtepi32_ps(iz));
+			xs = _mm256_mul_ps(_mm256_mul_ps(xs, xs), _mm256_sub_ps(three, _mm256_mul_ps(two, xs)));
+			ys = _mm256_mul_ps(_mm256_mul_ps(ys, ys), _mm256_sub_ps(three, _mm256_mul_ps(two, ys)));
+			zs = _mm256_mul_ps(_mm256_mul_ps(zs, zs), _mm256_sub_ps(three, _mm256_mul_ps(two, zs)));
+
+			const __m256i x0p = _mm256_mullo_epi32(ix, prime_x);
+			const __m256i y0p = _mm256_mullo_epi32(iy, prime_y);
+			const __m256i z0p = _mm256_mullo_epi32(iz, prime_z);
+			const __m256i x1p = _mm256_add_epi32(x0p, prime_x);
+			const __m256i y1p = _mm256_add_epi32(y0p, prime_y);
+			const __m256i z1p = _mm256_add_epi32(z0p, prime_z);
+
+			const __m256 xf00 = lerp_avx2(val_coord_avx2(s, x0p, y0p, z0p, scale), val_coord_avx2(s, x1p, y0p, z0p, scale), xs);
+			const __m256 xf10 = lerp_avx2(val_coord_avx2(s, x0p, y1p, z0p, scale), val_coord_avx2(s, x1p, y1p, z0p, scale), xs);
+			const __m256 xf01 = lerp_avx2(val_coord_avx2(s, x0p, y0p, z1p, scale), val_coord_avx2(s, x1p, y0p, z1p, scale), xs);
+			const __m256 xf11 = lerp_avx2(val_coord_avx2(s, x0p, y1p, z1p, scale), val_coord_avx2(s, x1p, y1p, z1p, scale), xs);
+			const __m256 noise = lerp_avx2(lerp_avx2(xf00, xf10, ys), lerp_avx2(xf01, xf11, ys), zs);
+
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(noise, _mm256_set1_ps(amps.amp[o])));
+			px = _mm256_mul_ps(px, lacunarity);
+			py = _mm256_mul_ps(py, lacunarity);
+			pz = _mm256_mul_ps(pz, lacunarity);
+		}
+		_mm256_storeu_ps(r_out + i, sum);
+	}
+	// Leftovers go through the 4-wide path, then scalar
+	batch_sse41(seed, frequency, amps, x, y, z, r_out, i, count);
+}
+
+enum SimdLevel {
+	SIMD_SCALAR,
+	SIMD_SSE41,
+	SIMD_AVX2
+};
+
+SimdLevel detect_simd_level() {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return SIMD_AVX2;
+	}
+	if (__builtin_cpu_supports("sse4.1")) {
+		return SIMD_SSE41;
+	}
+	return SIMD_SCALAR;
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int max_leaf = info[0];
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	bool avx2 = false;
+	if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+	return avx2 ? SIMD_AVX2 : (sse41 ? SIMD_SSE41 : SIMD_SCALAR);
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+SimdLevel get_level() {
+	// Detected once, thread-safe static init
+	static const SimdLevel level = detect_simd_level();
+	return level;
+}
+
+BatchKernel get_kernel() {
+	switch (get_level()) {
+		case SIMD_AVX2:
+			return batch_avx2;
+		case SIMD_SSE41:
+			return batch_sse41;
+		default:
+			return batch_scalar;
+	}
+}
+
+#else
+
+BatchKernel get_kernel() {
+	return batch_scalar;
+}
+
+#endif // VALUE_NOISE_X86
+
+} // namespace
+
+ValueNoise::ValueNoise() {
+	// FastNoiseLite defaults
+	seed = 0;
+	frequency = 0.01f;
+
+	// 1 / (sum of octave amplitudes) = 1 / 1.9375 for 5 octaves at gain 0.5
+	float amp = GAIN;
+	float amp_fractal = 1.0f;
+	for (int i = 1; i < OCTAVES; i++) {
+		amp_fractal += amp;
+		amp *= GAIN;
+	}
+	fractal_bounding = 1.0f / amp_fractal;
+}
+
+float ValueNoise::sample(float x, float y, float z) const {
+	float r;
+	batch_scalar((uint32_t)seed, frequency, OctaveAmps(fractal_bounding), &x, &y, &z, &r, 0, 1);
+	return r;
+}
+
+void ValueNoise::sample_batch(const float *x, const float *y, const float *z, float *r_out, int count) const {
+	static const BatchKernel kernel = get_kernel();
+	kernel((uint32_t)seed, frequency, OctaveAmps(fractal_bounding), x, y, z, r_out, 0, count);
+}
+
+const char *ValueNoise::get_simd_level() {
+#ifdef VALUE_NOISE_X86
+	switch (get_level()) {
+		case SIMD_AVX2:
+			return "avx2";
+		case SIMD_SSE41:
+			return "sse4.1";
+		default:
+			break;
+	}
+#endif
+	return "scalar";
+}
@@ -0,0 +1,44 @@
+#ifndef VALUE_NOISE_H
+#define VALUE_NOISE_H
+
+#include <cstdint>
+
+namespace godot {
+
+// In-process copy of FastNoiseLite's TYPE_VALUE noise with the engine's
+// default fractal settings (FBm, 5 octaves, lacunarity 2, gain 0.5,
+// weighted strength 0), so the wobble pass never crosses into the engine.
+// Follows FastNoiseLite operation for operation in float, so results are
+// bit-identical to FastNoiseLite.get_noise_3d() on single-precision engine
+// builds. With real_t=double the engine samples the unrounded coordinate,
+// which can differ by a few ULP near lattice boundaries.
+class ValueNoise {
+private:
+	int32_t seed;
+	float frequency;
+	float fractal_bounding;
+
+public:
+	static const int OCTAVES = 5;
+
+	ValueNoise();
+
+	void set_seed(int32_t p_seed) { seed = p_seed; }
+	int32_t get_seed() const { return seed; }
+	void set_frequency(float p_frequency) { frequency = p_frequency; }
+	float get_frequency() const { return frequency; }
+
+	// Same as FastNoiseLite::get_noise_3d(x, y, z)
+	float sample(float x, float y, float z) const;
+
+	// Samples count points at once, using AVX2 or SSE4.1 lanes when the CPU has them.
+	// Every lane gives exactly the same result as sample().
+	void sample_batch(const float *x, const float *y, const float *z, float *r_out, int count) const;
+
+	// "avx2", "sse4.1" or "scalar" - whichever sample_batch() picked on this CPU
+	static const char *get_simd_level();
+};
+
+} // namespace godot
+
+#endif // VALUE_NOISE_H
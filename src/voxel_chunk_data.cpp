@@ -0,0 +1,290 @@
+#include "voxel_chunk_data.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <algorithm>
+#include <map>
+#include <cstring>
+
+using namespace godot;
+
+VoxelChunkData::VoxelChunkData() {
+	setup(Vector3i(0, 0, 0), DEFAULT_SIZE, DEFAULT_SIZE, DEFAULT_SIZE);
+}
+
+VoxelChunkData::~VoxelChunkData() {
+}
+
+VoxelData VoxelChunkData::_record_from_array(const Array &p_props) {
+	// Same layout as VoxelChunk.gd: [blocktype, tx, ty, rot, vflip, layer]
+	VoxelData vd;
+	vd.shape_type = (uint8_t)(int)p_props[0];
+	vd.tx = (int16_t)(int)p_props[1];
+	vd.ty = (int16_t)(int)p_props[2];
+	vd.rot = (int8_t)(int)p_props[3];
+	vd.vflip = (bool)p_props[4];
+	vd.layer = p_props.size() > 5 ? (int8_t)(int)p_props[5] : 0;
+	return vd;
+}
+
+Array VoxelChunkData::_record_to_array(const VoxelData &p_record) {
+	Array props;
+	props.resize(6);
+	props[0] = p_record.shape_type;
+	props[1] = p_record.tx;
+	props[2] = p_record.ty;
+	props[3] = p_record.rot;
+	props[4] = p_record.vflip;
+	props[5] = p_record.layer;
+	return props;
+}
+
+void VoxelChunkData::setup(const Vector3i &p_chunk_coord, int p_size_x, int p_size_y, int p_size_z) {
+	chunk_coord = p_chunk_coord;
+	size_x = p_size_x > 0 ? p_size_x : DEFAULT_SIZE;
+	size_y = p_size_y > 0 ? p_size_y : DEFAULT_SIZE;
+	size_z = p_size_z > 0 ? p_size_z : DEFAULT_SIZE;
+	origin = Vector3i(chunk_coord.x * size_x, chunk_coord.y * size_y, chunk_coord.z * size_z);
+
+	positions.clear();
+	records.clear();
+	index_grid.assign(size_x * size_y * size_z, -1);
+}
+
+void VoxelChunkData::clear() {
+	positions.clear();
+	records.clear();
+	std::fill(index_grid.begin(), index_grid.end(), -1);
+}
+
+bool VoxelChunkData::add_voxel(const Vector3i &p_pos, const Array &p_props) {
+	if (p_props.size() < 5) {
+		ERR_PRINT(vformat("VoxelChunkData.add_voxel: expected [blocktype,tx,ty,rot,vflip,layer], got %d entries", p_props.size()));
+		return false;
+	}
+	const VoxelData vd = _record_from_array(p_props);
+	return add_voxel_fields(p_pos, vd.shape_type, vd.tx, vd.ty, vd.rot, vd.vflip, vd.layer);
+}
+
+bool VoxelChunkData::add_voxel_fields(const Vector3i &p_pos, int p_shape_type, int p_tx, int p_ty, int p_rot, bool p_vflip, int p_layer) {
+	VoxelData vd;
+	vd.shape_type = (uint8_t)p_shape_type;
+	vd.tx = (int16_t)p_tx;
+	vd.ty = (int16_t)p_ty;
+	vd.rot = (int8_t)p_rot;
+	vd.vflip = p_vflip;
+	vd.layer = (int8_t)p_layer;
+	// Voxels outside the chunk or already present are rejected, like voxel_dict.has() in VoxelChunk.gd
+	return _add_record(p_pos, vd);
+}
+
+bool VoxelChunkData::remove_voxel(const Vector3i &p_pos) {
+	const int cell = _cell_index(p_pos);
+	if (cell < 0) {
+		return false;
+	}
+	const int32_t index = index_grid[cell];
+	if (index == -1) {
+		return false;
+	}
+
+	// Swap-remove: move the last voxel into the hole and repoint its grid cell
+	const int32_t last = (int32_t)positions.size() - 1;
+	if (index != last) {
+		positions[index] = positions[last];
+		records[index] = records[last];
+		index_grid[_cell_index(positions[index])] = index;
+	}
+	positions.pop_back();
+	records.pop_back();
+	index_grid[cell] = -1;
+	return true;
+}
+
+bool VoxelChunkData::set_voxel_properties(const Vector3i &p_pos, const Array &p_props) {
+	const int index = get_voxel_index(p_pos);
+	if (index == -1 || p_props.size() < 5) {
+		return false;
+	}
+	const VoxelData vd = _record_from_array(p_props);
+	VoxelData &current = records[index];
+	if (memcmp(&current, &vd, sizeof(VoxelData)) == 0) {
+		return false;
+	}
+	current = vd;
+	return true;
+}
+
+void VoxelChunkData::set_from_arrays(const TypedArray<Vector3i> &p_voxels, const Array &p_voxel_properties) {
+	clear();
+	const int count = MIN(p_voxels.size(), p_voxel_properties.size());
+	positions.reserve(count);
+	records.reserve(count);
+	for (int i = 0; i < count; i++) {
+		const Variant &entry = p_voxel_properties[i];
+		// Same check as add_voxel, a short entry would index past the Array
+		const Array props = entry.get_type() == Variant::ARRAY ? (Array)entry : Array();
+		if (props.size() < 5) {
+			ERR_PRINT(vformat("VoxelChunkData.set_from_arrays: expected [blocktype,tx,ty,rot,vflip,layer], got %d entries", props.size()));
+			continue;
+		}
+		const Vector3i pos = p_voxels[i];
+		_add_record(pos, _record_from_array(props));
+	}
+}
+
+void VoxelChunkData::set_from_packed(const PackedInt32Array &p_positions, const PackedByteArray &p_records) {
+	clear();
+	const int64_t count = p_positions.size() / 3;
+	ERR_FAIL_COND_MSG(p_records.size() < count * PACKED_RECORD_SIZE, vformat("VoxelChunkData.set_from_packed: %d positions but only %d record bytes", count, p_records.size()));
+	const int32_t *pos = p_positions.ptr();
+	const uint8_t *rec = p_records.ptr();
+	for (int64_t i = 0; i < count; i++) {
+		_add_record(Vector3i(pos[i * 3], pos[i * 3 + 1], pos[i * 3 + 2]), decode_record(rec + i * PACKED_RECORD_SIZE));
+	}
+}
+
+static inline int floor_div(int a, int b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+Dictionary VoxelChunkData::split_packed_voxels(const PackedInt32Array &p_positions, const PackedByteArray &p_records, const Vector3i &p_chunk_size) {
+	Dictionary result;
+	const int64_t count = p_positions.size() / 3;
+	ERR_FAIL_COND_V_MSG(p_records.size() < count * PACKED_RECORD_SIZE, result, vformat("VoxelChunkData.split_packed_voxels: %d positions but only %d record bytes", count, p_records.size()));
+	const int sx = p_chunk_size.x > 0 ? p_chunk_size.x : DEFAULT_SIZE;
+	const int sy = p_chunk_size.y > 0 ? p_chunk_size.y : DEFAULT_SIZE;
+	const int sz = p_chunk_size.z > 0 ? p_chunk_size.z : DEFAULT_SIZE;
+
+	std::map<Vector3i, Ref<VoxelChunkData>> chunks;
+	// Saves are written chunk by chunk, so consecutive voxels nearly always share one
+	VoxelChunkData *current = nullptr;
+	Vector3i current_coord;
+	const int32_t *pos = p_positions.ptr();
+	const uint8_t *rec = p_records.ptr();
+	for (int64_t i = 0; i < count; i++) {
+		const Vector3i p(pos[i * 3], pos[i * 3 + 1], pos[i * 3 + 2]);
+		const Vector3i coord(floor_div(p.x, sx), floor_div(p.y, sy), floor_div(p.z, sz));
+		if (current == nullptr || coord != current_coord) {
+			Ref<VoxelChunkData> &chunk = chunks[coord];
+			if (chunk.is_null()) {
+				chunk.instantiate();
+				chunk->setup(coord, sx, sy, sz);
+			}
+			current = chunk.ptr();
+			current_coord = coord;
+		}
+		current->_add_record(p, decode_record(rec + i * PACKED_RECORD_SIZE));
+	}
+
+	for (const std::pair<const Vector3i, Ref<VoxelChunkData>> &entry : chunks) {
+		result[entry.first] = entry.second;
+	}
+	return result;
+}
+
+Ref<VoxelChunkData> VoxelChunkData::duplicate_chunk() const {
+	Ref<VoxelChunkData> copy;
+	copy.instantiate();
+	copy->chunk_coord = chunk_coord;
+	copy->size_x = size_x;
+	copy->size_y = size_y;
+	copy->size_z = size_z;
+	copy->origin = origin;
+	copy->positions = positions;
+	copy->records = records;
+	copy->index_grid = index_grid;
+	return copy;
+}
+
+bool VoxelChunkData::has_voxel(const Vector3i &p_pos) const {
+	return get_voxel_index(p_pos) != -1;
+}
+
+int VoxelChunkData::get_voxel_index(const Vector3i &p_pos) const {
+	const int cell = _cell_index(p_pos);
+	return cell < 0 ? -1 : index_grid[cell];
+}
+
+Array VoxelChunkData::get_voxel_properties(const Vector3i &p_pos) const {
+	const int index = get_voxel_index(p_pos);
+	if (index == -1) {
+		return Array();
+	}
+	return _record_to_array(records[index]);
+}
+
+int VoxelChunkData::get_voxel_count() const {
+	return (int)positions.size();
+}
+
+Vector3i VoxelChunkData::get_voxel_position(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)positions.size(), Vector3i());
+	return positions[p_index];
+}
+
+Array VoxelChunkData::get_voxel_properties_at(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)records.size(), Array());
+	return _record_to_array(records[p_index]);
+}
+
+TypedArray<Vector3i> VoxelChunkData::get_positions() const {
+	TypedArray<Vector3i> result;
+	result.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); i++) {
+		result[i] = positions[i];
+	}
+	return result;
+}
+
+PackedInt32Array VoxelChunkData::get_packed_positions() const {
+	PackedInt32Array result;
+	result.resize(positions.size() * 3);
+	int32_t *dst = result.ptrw();
+	for (size_t i = 0; i < positions.size(); i++) {
+		dst[i * 3] = positions[i].x;
+		dst[i * 3 + 1] = positions[i].y;
+		dst[i * 3 + 2] = positions[i].z;
+	}
+	return result;
+}
+
+PackedByteArray VoxelChunkData::get_packed_records() const {
+	PackedByteArray result;
+	result.resize(records.size() * PACKED_RECORD_SIZE);
+	uint8_t *dst = result.ptrw();
+	for (size_t i = 0; i < records.size(); i++) {
+		encode_record(records[i], dst + i * PACKED_RECORD_SIZE);
+	}
+	return result;
+}
+
+Vector3i VoxelChunkData::get_chunk_coord() const {
+	return chunk_coord;
+}
+
+Vector3i VoxelChunkData::get_size() const {
+	return Vector3i(size_x, size_y, size_z);
+}
+
+void VoxelChunkData::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("setup", "chunk_coord", "size_x", "size_y", "size_z"), &VoxelChunkData::setup);
+	ClassDB::bind_method(D_METHOD("clear"), &VoxelChunkData::clear);
+	ClassDB::bind_method(D_METHOD("add_voxel", "pos", "props"), &VoxelChunkData::add_voxel);
+	ClassDB::bind_method(D_METHOD("add_voxel_fields", "pos", "shape_type", "tx", "ty", "rot", "vflip", "layer"), &VoxelChunkData::add_voxel_fields);
+	ClassDB::bind_method(D_METHOD("remove_voxel", "pos"), &VoxelChunkData::remove_voxel);
+	ClassDB::bind_method(D_METHOD("set_voxel_properties", "pos", "props"), &VoxelChunkData::set_voxel_properties);
+	ClassDB::bind_method(D_METHOD("set_from_arrays", "voxels", "voxel_properties"), &VoxelChunkData::set_from_arrays);
+	ClassDB::bind_method(D_METHOD("set_from_packed", "positions", "records"), &VoxelChunkData::set_from_packed);
+	ClassDB::bind_static_method("VoxelChunkData", D_METHOD("split_packed_voxels", "positions", "records", "chunk_size"), &VoxelChunkData::split_packed_voxels, DEFVAL(Vector3i(DEFAULT_SIZE, DEFAULT_SIZE, DEFAULT_SIZE)));
+	ClassDB::bind_method(D_METHOD("duplicate_chunk"), &VoxelChunkData::duplicate_chunk);
+	ClassDB::bind_method(D_METHOD("has_voxel", "pos"), &VoxelChunkData::has_voxel);
+	ClassDB::bind_method(D_METHOD("get_voxel_index", "pos"), &VoxelChunkData::get_voxel_index);
+	ClassDB::bind_method(D_METHOD("get_voxel_properties", "pos"), &VoxelChunkData::get_voxel_properties);
+	ClassDB::bind_method(D_METHOD("get_voxel_count"), &VoxelChunkData::get_voxel_count);
+	ClassDB::bind_method(D_METHOD("get_voxel_position", "index"), &VoxelChunkData::get_voxel_position);
+	ClassDB::bind_method(D_METHOD("get_voxel_properties_at", "index"), &VoxelChunkData::get_voxel_properties_at);
+	ClassDB::bind_method(D_METHOD("get_positions"), &VoxelChunkData::get_positions);
+	ClassDB::bind_method(D_METHOD("get_packed_positions"), &VoxelChunkData::get_packed_positions);
+	ClassDB::bind_method(D_METHOD("get_packed_records"), &VoxelChunkData::get_packed_records);
+	ClassDB::bind_method(D_METHOD("get_chunk_coord"), &VoxelChunkData::get_chunk_coord);
+	ClassDB::bind_method(D_METHOD("get_size"), &VoxelChunkData::get_size);
+}
@@ -0,0 +1,144 @@
+#ifndef VOXEL_CHUNK_DATA_H
+#define VOXEL_CHUNK_DATA_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace godot {
+
+// Native form of the GDScript property array [blocktype, tx, ty, rot, vflip, layer].
+// Laid out so the whole record is 8 bytes with no packing pragmas.
+struct VoxelData {
+	int16_t tx, ty;
+	uint8_t shape_type;
+	int8_t rot;
+	bool vflip;
+	int8_t layer;
+};
+static_assert(sizeof(VoxelData) == 8, "VoxelData must stay 8 bytes");
+
+// Storage for the voxels of one chunk, replacing the voxels / voxel_properties /
+// voxel_dict triple in VoxelChunk.gd.
+// Structure of arrays: positions[i] and records[i] describe the same voxel, and
+// index_grid maps a local cell to i (or -1), so lookups never touch a Variant.
+class VoxelChunkData : public RefCounted {
+	GDCLASS(VoxelChunkData, RefCounted)
+
+public:
+	static const int DEFAULT_SIZE = 24;
+
+private:
+	Vector3i chunk_coord;
+	int size_x, size_y, size_z;
+	Vector3i origin; // chunk_coord * size, world position of local (0,0,0)
+
+	std::vector<Vector3i> positions;
+	std::vector<VoxelData> records;
+	std::vector<int32_t> index_grid;
+
+	// Local grid cell for a world position, or -1 when outside this chunk
+	inline int _cell_index(const Vector3i &p_pos) const {
+		const int lx = p_pos.x - origin.x;
+		const int ly = p_pos.y - origin.y;
+		const int lz = p_pos.z - origin.z;
+		if ((unsigned)lx >= (unsigned)size_x || (unsigned)ly >= (unsigned)size_y || (unsigned)lz >= (unsigned)size_z) {
+			return -1;
+		}
+		return lx + ly * size_x + lz * size_x * size_y;
+	}
+
+	static VoxelData _record_from_array(const Array &p_props);
+	static Array _record_to_array(const VoxelData &p_record);
+
+	// Appends a voxel, false when it is outside the chunk or already present
+	inline bool _add_record(const Vector3i &p_pos, const VoxelData &p_record) {
+		const int cell = _cell_index(p_pos);
+		if (cell < 0 || index_grid[cell] != -1) {
+			return false;
+		}
+		index_grid[cell] = (int32_t)positions.size();
+		positions.push_back(p_pos);
+		records.push_back(p_record);
+		return true;
+	}
+
+protected:
+	static void _bind_methods();
+
+public:
+	// Fixed-size byte form of a VoxelData used by the packed save paths:
+	// tx (s16 LE), ty (s16 LE), shape_type, rot, vflip (0/1), layer
+	static const int PACKED_RECORD_SIZE = 8;
+
+	static inline void encode_record(const VoxelData &p_record, uint8_t *r_dst) {
+		r_dst[0] = (uint8_t)p_record.tx;
+		r_dst[1] = (uint8_t)((uint16_t)p_record.tx >> 8);
+		r_dst[2] = (uint8_t)p_record.ty;
+		r_dst[3] = (uint8_t)((uint16_t)p_record.ty >> 8);
+		r_dst[4] = p_record.shape_type;
+		r_dst[5] = (uint8_t)p_record.rot;
+		r_dst[6] = p_record.vflip ? 1 : 0;
+		r_dst[7] = (uint8_t)p_record.layer;
+	}
+
+	static inline VoxelData decode_record(const uint8_t *p_src) {
+		VoxelData vd;
+		vd.tx = (int16_t)(p_src[0] | (p_src[1] << 8));
+		vd.ty = (int16_t)(p_src[2] | (p_src[3] << 8));
+		vd.shape_type = p_src[4];
+		vd.rot = (int8_t)p_src[5];
+		vd.vflip = p_src[6] != 0;
+		vd.layer = (int8_t)p_src[7];
+		return vd;
+	}
+
+	VoxelChunkData();
+	~VoxelChunkData();
+
+	void setup(const Vector3i &p_chunk_coord, int p_size_x, int p_size_y, int p_size_z);
+	void clear();
+
+	bool add_voxel(const Vector3i &p_pos, const Array &p_props);
+	bool add_voxel_fields(const Vector3i &p_pos, int p_shape_type, int p_tx, int p_ty, int p_rot, bool p_vflip, int p_layer);
+	bool remove_voxel(const Vector3i &p_pos);
+	bool set_voxel_properties(const Vector3i &p_pos, const Array &p_props);
+	void set_from_arrays(const TypedArray<Vector3i> &p_voxels, const Array &p_voxel_properties);
+	// Positions as x,y,z triplets and PACKED_RECORD_SIZE byte records, as returned by
+	// OeufSerializer.deserialize_game_data_packed(). Voxels outside the chunk are skipped.
+	void set_from_packed(const PackedInt32Array &p_positions, const PackedByteArray &p_records);
+	// Buckets a whole level's packed voxels into chunks in one pass: chunk_coord -> VoxelChunkData
+	static Dictionary split_packed_voxels(const PackedInt32Array &p_positions, const PackedByteArray &p_records, const Vector3i &p_chunk_size);
+	Ref<VoxelChunkData> duplicate_chunk() const;
+
+	bool has_voxel(const Vector3i &p_pos) const;
+	int get_voxel_index(const Vector3i &p_pos) const;
+	Array get_voxel_properties(const Vector3i &p_pos) const;
+	int get_voxel_count() const;
+	Vector3i get_voxel_position(int p_index) const;
+	Array get_voxel_properties_at(int p_index) const;
+	TypedArray<Vector3i> get_positions() const;
+	// Flat forms for the packed save paths, in the same order as get_positions()
+	PackedInt32Array get_packed_positions() const;
+	PackedByteArray get_packed_records() const;
+	Vector3i get_chunk_coord() const;
+	Vector3i get_size() const;
+
+	// Native accessors used by VoxelMesher - no Variant conversion
+	inline const Vector3i *get_positions_ptr() const { return positions.data(); }
+	inline const VoxelData *get_records_ptr() const { return records.data(); }
+	inline const int32_t *get_index_grid_ptr() const { return index_grid.data(); }
+	inline int get_size_x() const { return size_x; }
+	inline int get_size_y() const { return size_y; }
+	inline int get_size_z() const { return size_z; }
+};
+
+} // namespace godot
+
+#endif // VOXEL_CHUNK_DATA_H
@@ -3,10 +3,16 @@
 #include <godot_cpp/classes/mesh.hpp>
 #include <godot_cpp/classes/array_mesh.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
 #include <cstring>
 #include <cstdint>
 #include <cmath>
 #include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 
 using namespace godot;
@@ -79,30 +85,149 @@ VoxelMesher::VoxelMesher() {
 	cached_noise1 = noise1.ptr();
 	cached_noise2 = noise2.ptr();
 	cached_noise3 = noise3.ptr();
+
+	// Native copies of the three noises above, same frequencies (seeds follow in initialize_noise)
+	native_noise1.set_frequency(12424.12f);
+	native_noise2.set_frequency(23123.23f);
+	native_noise3.set_frequency(4123.4124f);
+	native_noise = true;
 	
-	// Initialize cached dimensions to invalid values
-	cached_size_x = cached_size_y = cached_size_z = -1;
+	active_batch = nullptr;
+	indexed_output = false;
+	face_runs_output = false;
+	mesh_config_generation = 0;
+	compress_attributes = true;
+
+	// No shapes until parse_shapes; _build_emit_templates walks all 256 keys
+	for (int i = 0; i < 256; i++) {
+		shape_lookup_valid[i] = false;
+		shape_lookup_array[i] = nullptr;
+	}
 }
 
 VoxelMesher::~VoxelMesher() {
 }
 
+void VoxelMesher::set_indexed_output(bool p_enabled) {
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
+	indexed_output = p_enabled;
+	_bump_mesh_config();
+}
+
+bool VoxelMesher::get_indexed_output() const {
+	return indexed_output;
+}
+
+void VoxelMesher::set_face_runs_output(bool p_enabled) {
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
+	face_runs_output = p_enabled;
+	_bump_mesh_config();
+}
+
+bool VoxelMesher::get_face_runs_output() const {
+	return face_runs_output;
+}
+
+Vector2i VoxelMesher::triangle_to_voxel_face(const PackedInt32Array &face_runs, int tri_index) {
+	const int run_count = (int)face_runs.size() / 2;
+	if (tri_index < 0 || run_count == 0) {
+		return Vector2i(-1, -1);
+	}
+	const int32_t *runs = face_runs.ptr();
+
+	// Last run starting at or before tri_index
+	int lo = 0;
+	int hi = run_count - 1;
+	while (lo < hi) {
+		const int mid = (lo + hi + 1) / 2;
+		if (runs[mid * 2] <= tri_index) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	const int32_t packed = runs[lo * 2 + 1];
+	// packed < 0: the sentinel run, tri_index is past the last triangle
+	if (runs[lo * 2] > tri_index || packed < 0) {
+		return Vector2i(-1, -1);
+	}
+	return Vector2i(packed >> FACE_RUN_FACE_BITS, packed & (MAX_SHAPE_FACES - 1));
+}
+
+void VoxelMesher::set_compress_attributes(bool p_enabled) {
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
+	compress_attributes = p_enabled;
+	_bump_mesh_config();
+}
+
+bool VoxelMesher::get_compress_attributes() const {
+	return compress_attributes;
+}
+
 void VoxelMesher::initialize_noise(int seed) {
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
 	noise1->set_seed(13123123); // Fixed seeds from GDScript
 	noise2->set_seed(123123);
 	noise3->set_seed(132);
+
+	native_noise1.set_seed(13123123);
+	native_noise2.set_seed(123123);
+	native_noise3.set_seed(132);
+
+	// Cached noise belongs to the previous seeds
+	wobble_cache.clear();
+	_bump_mesh_config();
+}
+
+void VoxelMesher::set_wobble_cache_limit_mb(int p_megabytes) {
+	wobble_cache.set_memory_limit((size_t)MAX(0, p_megabytes) * 1024 * 1024);
+}
+
+int VoxelMesher::get_wobble_cache_limit_mb() const {
+	return (int)(wobble_cache.get_memory_limit() / (1024 * 1024));
+}
+
+void VoxelMesher::clear_wobble_cache() {
+	wobble_cache.clear();
+}
+
+Dictionary VoxelMesher::get_wobble_cache_stats() {
+	Dictionary stats;
+	stats["hits"] = (int64_t)wobble_cache.get_hits();
+	stats["misses"] = (int64_t)wobble_cache.get_misses();
+	stats["blocks"] = (int64_t)wobble_cache.get_block_count();
+	stats["memory_bytes"] = (int64_t)wobble_cache.get_memory_usage();
+	return stats;
+}
+
+void VoxelMesher::set_native_noise(bool p_enabled) {
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
+	native_noise = p_enabled;
+}
+
+bool VoxelMesher::get_native_noise() const {
+	return native_noise;
+}
+
+String VoxelMesher::get_native_noise_simd_level() const {
+	return String(ValueNoise::get_simd_level());
 }
 
 void VoxelMesher::set_texture_dimensions(float width, float height) {
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
 	tex_width = width;
 	tex_height = height;
 	tile_w_local = TILE_W / tex_width;
 	tile_h_local = TILE_H / tex_height;
 	du = Vector2(tile_w_local, 0);
 	dv = Vector2(0, tile_h_local);
+	_bump_mesh_config();
 }
 
 void VoxelMesher::parse_shapes(const Array &gd_database, const Dictionary &gd_uv_patterns) {
+	// Remesh queue workers read all of this, and the emit templates get reallocated
+	std::unique_lock<std::shared_mutex> config_lock(config_mutex);
+
 	// Clear direct array lookup - initialize all entries as invalid
 	for (int i = 0; i < 256; i++) {
 		shape_lookup_valid[i] = false;
@@ -142,6 +267,13 @@ void VoxelMesher::parse_shapes(const Array &gd_database, const Dictionary &gd_uv
 			for (int f = 0; f < shape_flips_arr.size(); f++) {
 				Dictionary shape_dict = shape_flips_arr[f];
 				uint8_t key = ((uint8_t)i) | ((uint8_t)r << 4) | ((uint8_t)f << 6);
+
+				// Face runs could not name the extra faces; the key stays invalid and these voxels are skipped
+				Array faces = shape_dict["faces"];
+				if (faces.size() > MAX_SHAPE_FACES) {
+					ERR_PRINT(vformat("parse_shapes: shape %d rotation %d flip %d has %d faces, at most %d are supported", i, r, f, faces.size(), MAX_SHAPE_FACES));
+					continue;
+				}
 				
 				ShapeVariant &sv = shape_database[key];
 
@@ -153,7 +285,6 @@ void VoxelMesher::parse_shapes(const Array &gd_database, const Dictionary &gd_uv
 				}
 
 				// Faces
-				Array faces = shape_dict["faces"];
 				Array uvs = shape_dict["uvs"];
 				Array voffsets = shape_dict["face_tile_voffset"];
 				Array occupyface = shape_dict["occupyface"];
@@ -226,6 +357,80 @@ void VoxelMesher::parse_shapes(const Array &gd_database, const Dictionary &gd_uv
 			occupancy_fits_table[sub_idx * 8 + cont_idx] = fits;
 		}
 	}
+
+	_build_emit_templates();
+	_bump_mesh_config();
+}
+
+void VoxelMesher::_build_emit_templates() {
+	emit_templates.assign(256 * 64, EmitTemplate());
+	template_verts.clear();
+	template_tris.clear();
+	max_template_faces = 0;
+
+	std::vector<int32_t> remap;
+	for (int key = 0; key < 256; key++) {
+		if (!shape_lookup_valid[key]) {
+			continue;
+		}
+		const ShapeVariant &shape = *shape_lookup_array[key];
+		const int vertex_count = (int)shape.vertices.size();
+
+		for (uint32_t mask = 0; mask < 64; mask++) {
+			EmitTemplate &tmpl = emit_templates[key * 64 + mask];
+			tmpl.vert_start = (uint32_t)template_verts.size();
+			tmpl.tri_start = (uint32_t)template_tris.size();
+			remap.assign(vertex_count, -1);
+
+			for (size_t face_idx = 0; face_idx < shape.faces.size(); face_idx++) {
+				if (face_idx < 6 && ((mask >> face_idx) & 1)) {
+					continue;
+				}
+				const FaceData &face = shape.faces[face_idx];
+				const std::vector<Vector2> *uv_ptr = nullptr;
+				if (face.uv_pattern_index >= 0 && face.uv_pattern_index < (int)uv_patterns.size()) {
+					uv_ptr = &uv_patterns[face.uv_pattern_index];
+				}
+
+				for (size_t tri_start = 0; tri_start + 2 < face.indices.size(); tri_start += 3) {
+					TemplateTri tri;
+					tri.face = (uint8_t)face_idx;
+					tri.has_uv_pattern = uv_ptr && (tri_start + 2 < uv_ptr->size());
+					bool valid = true;
+					for (int k = 0; k < 3; k++) {
+						const int vertex = face.indices[tri_start + k];
+						if ((unsigned)vertex >= (unsigned)vertex_count) {
+							valid = false;
+							break;
+						}
+						if (remap[vertex] == -1) {
+							remap[vertex] = (int32_t)(template_verts.size() - tmpl.vert_start);
+							template_verts.push_back((uint16_t)vertex);
+						}
+						tri.corner[k] = (uint16_t)remap[vertex];
+						tri.uv[k] = tri.has_uv_pattern ? (*uv_ptr)[tri_start + k] : Vector2();
+					}
+					if (!valid) {
+						ERR_PRINT("parse_shapes: face index out of range, triangle dropped");
+						continue;
+					}
+					template_tris.push_back(tri);
+				}
+			}
+
+			tmpl.vert_count = (uint32_t)template_verts.size() - tmpl.vert_start;
+			tmpl.tri_count = (uint32_t)template_tris.size() - tmpl.tri_start;
+
+			// Bounds the face runs one voxel can add (faces are contiguous)
+			uint32_t face_count = 0;
+			for (uint32_t t = tmpl.tri_start; t < tmpl.tri_start + tmpl.tri_count; t++) {
+				if (t == tmpl.tri_start || template_tris[t].face != template_tris[t - 1].face) {
+					face_count++;
+				}
+			}
+			max_template_faces = MAX(max_template_faces, face_count);
+		}
+	}
 }
 
 void VoxelMesher::_cache_wobbled_verts(const Vector3i &voxel, const ShapeVariant &shape, 
@@ -305,408 +510,1821 @@ Dictionary VoxelMesher::generate_chunk_mesh(
 		const Array &voxel_properties,
 		const Array &layer_visibility,
 		int size_x, int size_y, int size_z) {
-	
-	const int voxel_count = voxels.size();
-
-	Ref<ArrayMesh> array_mesh;
-	array_mesh.instantiate();
-
-	// Tri-voxel info to return for raycasting/interaction logic
-	PackedInt32Array tri_voxel_info;
-
-	// Early exit for empty chunks
-	if (voxel_count == 0) {
-		Dictionary result;
-		result["arraymesh"] = array_mesh;
-		result["tri_voxel_info"] = tri_voxel_info;
-		return result;
-	}
 
-	// Clear reusable output buffers (memory stays allocated)
-	final_vertices.clear();
-	final_normals.clear();
-	final_normals_smoothed.clear();
-	final_uvs.clear();
-	
-	tri_voxel_info.resize(0); 
+	const int voxel_count = voxels.size();
+	MeshScratch &scratch = main_scratch;
 
-	// Reserve space if needed (only grows, never shrinks)
-	const int reserve_size = voxel_count * 32;
-	if (final_vertices.capacity() < reserve_size) {
-		final_vertices.reserve(reserve_size);
-		final_normals.reserve(reserve_size);
-		final_normals_smoothed.reserve(reserve_size);
-		final_uvs.reserve(reserve_size);
-	}
+	// 1. Unpack Data Structures - reuse scratch buffers
+	scratch.unpacked_props.clear();
+	scratch.unpacked_voxels.clear();
 
-	// 1. Unpack Data Structures - reuse member buffers
-	unpacked_props.clear();
-	unpacked_voxels.clear();
-	
-	if (unpacked_props.capacity() < voxel_count) {
-		unpacked_props.reserve(voxel_count);
-		unpacked_voxels.reserve(voxel_count);
+	if ((int)scratch.unpacked_props.capacity() < voxel_count) {
+		scratch.unpacked_props.reserve(voxel_count);
+		scratch.unpacked_voxels.reserve(voxel_count);
 	}
 
 	// OPTIMIZATION: Unpack data in a single pass with minimal allocations
 	for (int i = 0; i < voxel_count; i++) {
-		unpacked_voxels.push_back(voxels[i]);
+		scratch.unpacked_voxels.push_back(voxels[i]);
 
 		const Array &props = voxel_properties[i];
 		VoxelData vd;
 		// Direct access - assumes valid data structure
-		vd.shape_type = (int16_t)(int)props[0];
+		vd.shape_type = (uint8_t)(int)props[0];
 		vd.tx = (int16_t)(int)props[1];
 		vd.ty = (int16_t)(int)props[2];
 		vd.rot = (int8_t)(int)props[3];
 		vd.vflip = (bool)props[4];
 		vd.layer = (int8_t)(int)props[5];
-		unpacked_props.push_back(vd);
+		scratch.unpacked_props.push_back(vd);
 	}
 
-	// Layer visibility - convert once, reuse buffer
-	const int layer_count = layer_visibility.size();
-	layers_vis.clear();
-	if (layers_vis.capacity() < layer_count) {
-		layers_vis.reserve(layer_count);
-	}
-	for(int i = 0; i < layer_count; ++i) {
-		layers_vis.push_back(layer_visibility[i]);
-	}
+	ChunkInput input;
+	input.chunk_coord = chunk_coord;
+	input.voxels = scratch.unpacked_voxels.data();
+	input.voxel_props = scratch.unpacked_props.data();
+	input.voxel_count = voxel_count;
+	input.voxel_grid = nullptr;
+	input.size_x = size_x;
+	input.size_y = size_y;
+	input.size_z = size_z;
+
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+	input.layers_vis = layers_vis.data();
+	input.layer_count = (int)layers_vis.size();
+
+	return _mesh_chunk_cached(input, scratch);
+}
 
-	// Grid Cache - resize only if dimensions changed (they're constant, so this happens once)
-	const int grid_size = size_x * size_y * size_z;
-	if (cached_size_x != size_x || cached_size_y != size_y || cached_size_z != size_z) {
-		grid_cache.resize(grid_size);
-		cached_size_x = size_x;
-		cached_size_y = size_y;
-		cached_size_z = size_z;
+Dictionary VoxelMesher::generate_chunk_mesh_from_data(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const Array &neighbours) {
+
+	if (chunk_data.is_null()) {
+		ERR_PRINT("generate_chunk_mesh_from_data: chunk_data is null");
+		return Dictionary();
 	}
-	
-	// Clear grid cache (fill with -1)
-	std::fill(grid_cache.begin(), grid_cache.end(), -1);
-	
-	const Vector3i offset(chunk_coord.x * size_x, chunk_coord.y * size_y, chunk_coord.z * size_z);
-	const int stride_y = size_x;
-	const int stride_z = size_x * size_y;
 
-	// Populate grid cache - optimized bounds checking with single comparison
-	for (int i = 0; i < voxel_count; i++) {
-		const Vector3i &v = unpacked_voxels[i];
-		const int lx = v.x - offset.x;
-		const int ly = v.y - offset.y;
-		const int lz = v.z - offset.z;
-		
-		// Single bounds check using unsigned comparison trick
-		if ((unsigned)lx < (unsigned)size_x && 
-		    (unsigned)ly < (unsigned)size_y && 
-		    (unsigned)lz < (unsigned)size_z) {
-			grid_cache[lx + ly * stride_y + lz * stride_z] = i;
-		}
+	// No unpacking - the chunk already holds SoA records and a dense index grid
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+	input.layers_vis = layers_vis.data();
+	input.layer_count = (int)layers_vis.size();
+
+	// Optional neighbours in DIR_OFFSETS order (S, N, W, E, U, D); null entries are open
+	ChunkApron apron;
+	if (!neighbours.is_empty()) {
+		_build_apron_from_array(neighbours, input, apron);
+		input.apron = &apron;
 	}
 
-	// ALGORITHMIC OPTIMIZATION: Pre-cache shape variant pointers to avoid repeated lookups
-	// Reuse member buffer
-	voxel_cache.clear();
-	voxel_cache.resize(voxel_count);
-	
-	// Pre-cache all shape variants (one-time cost, eliminates repeated 3-level lookups)
-	for (int voxel_index = 0; voxel_index < voxel_count; voxel_index++) {
-		const VoxelData &props = unpacked_props[voxel_index];
-		CachedVoxelInfo &cache_entry = voxel_cache[voxel_index];
-		
-		// Early exit for invisible layers
-		if (props.layer >= layer_count || !layers_vis[props.layer]) {
-			cache_entry.valid = false;
-			continue;
-		}
+	return _mesh_chunk_cached(input, main_scratch);
+}
 
-		// Validate and cache shape access using direct array lookup - single byte key!
-		// Encoding: shape_type | (rotation << 4) | (vflip << 6) - fits in 8 bits
-		uint8_t lookup_key = ((uint8_t)props.shape_type) | ((uint8_t)props.rot << 4) | ((props.vflip ? 1 : 0) << 6);
-		
-		// Direct array access - O(1) with zero hash overhead!
-		if (!shape_lookup_valid[lookup_key]) {
-			cache_entry.valid = false;
-			continue;
+// 64-bit multiply/xor-shift mix over 8-byte words - cheap and good enough to key a cache
+static inline uint64_t hash_mix(uint64_t h, uint64_t v) {
+	h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+	h *= 0xff51afd7ed558ccdull;
+	return h ^ (h >> 33);
+}
+
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t size) {
+	const uint8_t *bytes = (const uint8_t *)data;
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		uint64_t word;
+		memcpy(&word, bytes + i, 8);
+		h = hash_mix(h, word);
+	}
+	uint64_t tail = 0;
+	memcpy(&tail, bytes + i, size - i);
+	return hash_mix(h, tail ^ ((uint64_t)size << 56));
+}
+
+uint64_t VoxelMesher::_hash_chunk_input(const ChunkInput &in) const {
+	uint64_t h = hash_mix(0, mesh_config_generation);
+	h = hash_bytes(h, &in.chunk_coord, sizeof(Vector3i));
+	h = hash_mix(h, (uint64_t)in.size_x | ((uint64_t)in.size_y << 20) | ((uint64_t)in.size_z << 40));
+	h = hash_bytes(h, in.voxels, in.voxel_count * sizeof(Vector3i));
+	h = hash_bytes(h, in.voxel_props, in.voxel_count * sizeof(VoxelData));
+	h = hash_bytes(h, in.layers_vis, in.layer_count);
+	if (in.apron != nullptr) {
+		for (int dir = 0; dir < 6; dir++) {
+			const std::vector<int16_t> &face = in.apron->faces[dir];
+			h = hash_bytes(h, face.data(), face.size() * sizeof(int16_t));
 		}
-		
-		// Cache the shape variant pointer - direct array access, fastest possible lookup!
-		cache_entry.shape_ptr = shape_lookup_array[lookup_key];
-		cache_entry.lookup_key = lookup_key; // Store for direct face occupancy cache access
-		cache_entry.voxel_pos = unpacked_voxels[voxel_index];
-		cache_entry.local_x = cache_entry.voxel_pos.x - offset.x;
-		cache_entry.local_y = cache_entry.voxel_pos.y - offset.y;
-		cache_entry.local_z = cache_entry.voxel_pos.z - offset.z;
-		cache_entry.valid = true;
 	}
+	return h;
+}
 
-	// Temporary buffers - reuse member buffers (cleared per voxel)
-	cached_wobbled_local_verts.clear();
-	cached_vertex_colors.clear();
-	if (cached_wobbled_local_verts.capacity() < 512) {
-		cached_wobbled_local_verts.reserve(512);
-		cached_vertex_colors.reserve(512);
+Dictionary VoxelMesher::_mesh_chunk_cached(const ChunkInput &in, MeshScratch &scratch) {
+	const uint64_t hash = _hash_chunk_input(in);
+	Dictionary result;
+	if (mesh_cache.lookup(hash, in.chunk_coord, in.voxel_count, result)) {
+		return result;
 	}
 
-	// Use cached noise pointers - no .ptr() calls needed!
-	FastNoiseLite *n1 = cached_noise1;
-	FastNoiseLite *n2 = cached_noise2;
-	FastNoiseLite *n3 = cached_noise3;
+	_mesh_chunk(in, scratch, main_output);
+	result = _make_mesh_result(main_output);
 
-	// Pre-compute constants
-	const float noise_scale = 0.1f;
-	const float half_scale = 0.5f;
-	const float norm_threshold = 0.0001f;
-	const float default_color = 0.5f;
+	const size_t bytes = main_output.vertices.size() * (sizeof(Vector3) * 2 + sizeof(Color) + sizeof(Vector2)) +
+			(main_output.tri_voxel_info.size() + main_output.indices.size() + main_output.face_runs.size()) * sizeof(int32_t);
+	mesh_cache.insert(hash, in.chunk_coord, in.voxel_count, result, bytes);
+	return result;
+}
 
-	// Main voxel processing loop - single pass with lazy evaluation preserved
-	for (int voxel_index = 0; voxel_index < voxel_count; voxel_index++) {
-		const CachedVoxelInfo &cache_entry = voxel_cache[voxel_index];
-		
-		// Skip invalid/invisible voxels
-		if (!cache_entry.valid) {
-			continue;
-		}
+void VoxelMesher::_bump_mesh_config() {
+	// Anything that changes the mesh for the same voxels makes every cached result stale
+	mesh_config_generation++;
+	mesh_cache.clear();
+}
 
-		const VoxelData &props = unpacked_props[voxel_index];
-		const ShapeVariant &shape_data = *cache_entry.shape_ptr; // Direct cached access!
+void VoxelMesher::set_mesh_cache_limit_mb(int p_megabytes) {
+	mesh_cache.set_memory_limit((size_t)MAX(0, p_megabytes) * 1024 * 1024);
+}
 
-		// LAZY CALCULATION: Don't calculate noise unless we actually render a face
-		bool wobbled_calculated = false;
+int VoxelMesher::get_mesh_cache_limit_mb() const {
+	return (int)(mesh_cache.get_memory_limit() / (1024 * 1024));
+}
 
-		const Vector3 v_vec(cache_entry.voxel_pos.x, cache_entry.voxel_pos.y, cache_entry.voxel_pos.z);
+void VoxelMesher::clear_mesh_cache() {
+	mesh_cache.clear();
+}
 
-		// Process faces
-		const size_t face_count = shape_data.faces.size();
-		for (size_t face_idx = 0; face_idx < face_count; face_idx++) {
-			const FaceData &face = shape_data.faces[face_idx];
-			const size_t indices_size = face.indices.size();
-			if (indices_size == 0) continue;
+Dictionary VoxelMesher::get_mesh_cache_stats() const {
+	Dictionary stats;
+	stats["hits"] = (int64_t)mesh_cache.get_hits();
+	stats["misses"] = (int64_t)mesh_cache.get_misses();
+	stats["entries"] = (int64_t)mesh_cache.get_entry_count();
+	stats["memory_bytes"] = (int64_t)mesh_cache.get_memory_usage();
+	return stats;
+}
 
-			// Neighbor check - optimized with early exits and cached shape access
-			if (face.occupy_face && face.face_occupancy != OCCUPANCY_EMPTY) {
-				const Vector3i &dir_offset = DIR_OFFSETS[face_idx];
-				const int nlx = cache_entry.local_x + dir_offset.x;
-				const int nly = cache_entry.local_y + dir_offset.y;
-				const int nlz = cache_entry.local_z + dir_offset.z;
+Dictionary VoxelMesher::generate_chunk_layered_mesh(
+		const Ref<VoxelChunkData> &chunk_data,
+		int layer_count,
+		const Array &neighbours) {
 
-				// Fast bounds check
-				if ((unsigned)nlx < (unsigned)size_x && 
-				    (unsigned)nly < (unsigned)size_y && 
-				    (unsigned)nlz < (unsigned)size_z) {
-					const int n_idx = grid_cache[nlx + nly * stride_y + nlz * stride_z];
-					if (n_idx != -1 && voxel_cache[n_idx].valid) {
-						const CachedVoxelInfo &n_cache = voxel_cache[n_idx];
-						
-						// Direct access to cached face occupancy - no shape->faces[dir] indirection!
-						const int opp_dir = OPPOSITE_DIR[face_idx];
-						const int neigh_occupancy = face_occupancy_cache[n_cache.lookup_key * 6 + opp_dir];
-						
-						// Direct lookup table access - eliminates function call overhead!
-						const int sub_idx = face.face_occupancy + 1;
-						const int cont_idx = neigh_occupancy + 1;
-						if (occupancy_fits_table[sub_idx * 8 + cont_idx]) {
-							continue; // Skip this face
-						}
-					}
-				}
-			}
+	if (chunk_data.is_null()) {
+		ERR_PRINT("generate_chunk_layered_mesh: chunk_data is null");
+		return Dictionary();
+	}
+	ERR_FAIL_COND_V_MSG(layer_count < 0 || layer_count > 127, Dictionary(), "generate_chunk_layered_mesh: layer_count must be 0..127");
+
+	// Meshed with every layer visible; split_layers keeps the faces that
+	// another layer covers instead of culling them
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+	std::vector<uint8_t> layers_vis(layer_count, 1);
+	input.layers_vis = layers_vis.data();
+	input.layer_count = layer_count;
+	input.split_layers = true;
+
+	ChunkApron apron;
+	if (!neighbours.is_empty()) {
+		_build_apron_from_array(neighbours, input, apron);
+		input.apron = &apron;
+	}
 
-			// Calculate wobbled vertices if needed (lazy evaluation)
-			if (!wobbled_calculated) {
-				cached_wobbled_local_verts.clear();
-				cached_vertex_colors.clear();
-				const size_t vert_count = shape_data.vertices.size();
-				cached_wobbled_local_verts.reserve(vert_count);
-				cached_vertex_colors.reserve(vert_count);
+	MeshOutput &out = main_output;
+	_mesh_chunk(input, main_scratch, out);
 
-				// OPTIMIZATION: Batch noise calculations with fast normalization
-				for (size_t i = 0; i < vert_count; i++) {
-					const Vector3 &base_local = shape_data.vertices[i];
-					
-					// Direct member access for world position
-					const Vector3 world_pos(
-						base_local.x + v_vec.x,
-						base_local.y + v_vec.y,
-						base_local.z + v_vec.z
-					);
-
-					// Noise calculations
-					const float nx = n1->get_noise_3dv(world_pos) * noise_scale;
-					const float ny = n2->get_noise_3dv(world_pos) * noise_scale;
-					const float nz = n3->get_noise_3dv(world_pos) * noise_scale;
-
-					// Wobbled vertex
-					const Vector3 wobbled_local(
-						base_local.x + nx,
-						base_local.y + ny,
-						base_local.z + nz
-					);
-					cached_wobbled_local_verts.push_back(wobbled_local);
-
-					// Fast normalized for color calculation using fast inverse sqrt
-					const float len_sq = wobbled_local.length_squared();
-					if (len_sq > norm_threshold) {
-						const float inv_len = fast_inv_sqrt(len_sq);
-						const float nsx = wobbled_local.x * inv_len;
-						const float nsy = wobbled_local.y * inv_len;
-						const float nsz = wobbled_local.z * inv_len;
-						cached_vertex_colors.push_back(Color(
-							(nsx + 1.0f) * half_scale,
-							(nsy + 1.0f) * half_scale,
-							(nsz + 1.0f) * half_scale
-						));
-					} else {
-						cached_vertex_colors.push_back(Color(default_color, default_color, default_color));
-					}
-				}
-				wobbled_calculated = true;
-			}
+	// Triangles per group, in ascending (layer, hidden_by) order
+	std::map<int32_t, int> group_sizes;
+	for (int32_t group : out.tri_groups) {
+		group_sizes[group]++;
+	}
 
-			// UV Calculation - pre-compute once per face
-			const float uv_tile_y = (float)(FACE_UV_COLGROUP_SIZE * props.ty + face.tile_voffset);
-			const Vector2 uv_offset(
-				du.x * (float)props.tx + dv.x * uv_tile_y,
-				du.y * (float)props.tx + dv.y * uv_tile_y
-			);
-			
-			const std::vector<Vector2> *uv_ptr = nullptr;
-			if (face.uv_pattern_index >= 0 && face.uv_pattern_index < (int)uv_patterns.size()) {
-				uv_ptr = &uv_patterns[face.uv_pattern_index];
-			}
-
-			// Triangulate
-			for (size_t tri_start = 0; tri_start < indices_size; tri_start += 3) {
-				// Store triangle info
-				tri_voxel_info.push_back(voxel_index);
-				tri_voxel_info.push_back((int)face_idx);
-
-				const int i0 = face.indices[tri_start + 0];
-				const int i1 = face.indices[tri_start + 1];
-				const int i2 = face.indices[tri_start + 2];
-
-				// Get vertices (references to avoid copies)
-				const Vector3 &v0_local = cached_wobbled_local_verts[i0];
-				const Vector3 &v1_local = cached_wobbled_local_verts[i1];
-				const Vector3 &v2_local = cached_wobbled_local_verts[i2];
-
-				// Simple scalar addition - SIMD overhead isn't worth it for 3 vectors
-				final_vertices.push_back(v0_local + v_vec);
-				final_vertices.push_back(v1_local + v_vec);
-				final_vertices.push_back(v2_local + v_vec);
-
-				// Vertex colors (already computed)
-				final_normals_smoothed.push_back(cached_vertex_colors[i0]);
-				final_normals_smoothed.push_back(cached_vertex_colors[i1]);
-				final_normals_smoothed.push_back(cached_vertex_colors[i2]);
-
-				// Face Normal - simple scalar cross product
-				float cross_x, cross_y, cross_z;
-				cross_product_normalized(
-					v0_local.x, v0_local.y, v0_local.z,
-					v1_local.x, v1_local.y, v1_local.z,
-					v2_local.x, v2_local.y, v2_local.z,
-					cross_x, cross_y, cross_z,
-					norm_threshold
-				);
-				
-				const Vector3 face_norm(cross_x, cross_y, cross_z);
-				final_normals.push_back(face_norm);
-				final_normals.push_back(face_norm);
-				final_normals.push_back(face_norm);
-
-				// UV coordinates - simple scalar addition
-				if (uv_ptr && (tri_start + 2 < uv_ptr->size())) {
-					const Vector2 &uv0 = (*uv_ptr)[tri_start + 0];
-					const Vector2 &uv1 = (*uv_ptr)[tri_start + 1];
-					const Vector2 &uv2 = (*uv_ptr)[tri_start + 2];
-					
-					final_uvs.push_back(uv0 + uv_offset);
-					final_uvs.push_back(uv1 + uv_offset);
-					final_uvs.push_back(uv2 + uv_offset);
-				} else {
-					final_uvs.push_back(uv_offset);
-					final_uvs.push_back(uv_offset);
-					final_uvs.push_back(uv_offset);
-				}
+	Array groups;
+	for (const std::pair<const int32_t, int> &entry : group_sizes) {
+		const int32_t group = entry.first;
+		const int tri_count = entry.second;
+
+		PackedVector3Array p_vertices;
+		PackedVector3Array p_normals;
+		PackedColorArray p_colors;
+		PackedVector2Array p_uvs;
+		PackedInt32Array p_tri_voxel_info;
+		p_vertices.resize(tri_count * 3);
+		p_normals.resize(tri_count * 3);
+		p_colors.resize(tri_count * 3);
+		p_uvs.resize(tri_count * 3);
+		p_tri_voxel_info.resize(tri_count * 2);
+		Vector3 *w_vertices = p_vertices.ptrw();
+		Vector3 *w_normals = p_normals.ptrw();
+		Color *w_colors = p_colors.ptrw();
+		Vector2 *w_uvs = p_uvs.ptrw();
+		int32_t *w_tri_voxel_info = p_tri_voxel_info.ptrw();
+
+		int written = 0;
+		for (size_t tri = 0; tri < out.tri_groups.size(); tri++) {
+			if (out.tri_groups[tri] != group) {
+				continue;
 			}
+			memcpy(w_vertices + written * 3, &out.vertices[tri * 3], 3 * sizeof(Vector3));
+			memcpy(w_normals + written * 3, &out.normals[tri * 3], 3 * sizeof(Vector3));
+			memcpy(w_colors + written * 3, &out.normals_smoothed[tri * 3], 3 * sizeof(Color));
+			memcpy(w_uvs + written * 3, &out.uvs[tri * 3], 3 * sizeof(Vector2));
+			w_tri_voxel_info[written * 2] = out.tri_voxel_info[tri * 2];
+			w_tri_voxel_info[written * 2 + 1] = out.tri_voxel_info[tri * 2 + 1];
+			written++;
 		}
+
+		Dictionary group_dict;
+		group_dict["layer"] = group >> 8;
+		group_dict["hidden_by"] = (group & 0xFF) - 1;
+		group_dict["vertices"] = p_vertices;
+		group_dict["normals"] = p_normals;
+		group_dict["colors"] = p_colors;
+		group_dict["uvs"] = p_uvs;
+		group_dict["tri_voxel_info"] = p_tri_voxel_info;
+		groups.push_back(group_dict);
 	}
 
-	// Bulk convert to PackedArrays using memcpy for maximum speed
-	PackedVector3Array p_vertices;
-	p_vertices.resize(final_vertices.size());
-	if (!final_vertices.empty()) {
-		memcpy(p_vertices.ptrw(), final_vertices.data(), final_vertices.size() * sizeof(Vector3));
+	Dictionary result;
+	result["groups"] = groups;
+	return result;
+}
+
+Dictionary VoxelMesher::compose_layer_mesh(const Dictionary &layered, const Array &layer_visibility) {
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+	const int layer_count = (int)layers_vis.size();
+
+	MeshOutput &out = main_output;
+	out.vertices.clear();
+	out.normals.clear();
+	out.normals_smoothed.clear();
+	out.uvs.clear();
+	out.tri_voxel_info.clear();
+	out.indices.clear();
+
+	// A group is drawn when its layer is shown and the layer covering it (if any) is hidden
+	const Array groups = layered.get("groups", Array());
+	for (int i = 0; i < groups.size(); i++) {
+		const Dictionary group = groups[i];
+		const int layer = group.get("layer", -1);
+		const int hidden_by = group.get("hidden_by", -1);
+		if ((unsigned)layer >= (unsigned)layer_count || !layers_vis[layer]) {
+			continue;
+		}
+		if (hidden_by >= 0 && hidden_by < layer_count && layers_vis[hidden_by]) {
+			continue;
+		}
+
+		const PackedVector3Array p_vertices = group.get("vertices", PackedVector3Array());
+		const PackedVector3Array p_normals = group.get("normals", PackedVector3Array());
+		const PackedColorArray p_colors = group.get("colors", PackedColorArray());
+		const PackedVector2Array p_uvs = group.get("uvs", PackedVector2Array());
+		const PackedInt32Array p_tri_voxel_info = group.get("tri_voxel_info", PackedInt32Array());
+		const int64_t vert_count = p_vertices.size();
+		if (p_normals.size() != vert_count || p_colors.size() != vert_count || p_uvs.size() != vert_count ||
+				p_tri_voxel_info.size() != vert_count / 3 * 2) {
+			ERR_PRINT("compose_layer_mesh: malformed group, skipped");
+			continue;
+		}
+
+		out.vertices.insert(out.vertices.end(), p_vertices.ptr(), p_vertices.ptr() + vert_count);
+		out.normals.insert(out.normals.end(), p_normals.ptr(), p_normals.ptr() + vert_count);
+		out.normals_smoothed.insert(out.normals_smoothed.end(), p_colors.ptr(), p_colors.ptr() + vert_count);
+		out.uvs.insert(out.uvs.end(), p_uvs.ptr(), p_uvs.ptr() + vert_count);
+		out.tri_voxel_info.insert(out.tri_voxel_info.end(), p_tri_voxel_info.ptr(), p_tri_voxel_info.ptr() + p_tri_voxel_info.size());
 	}
 
-	PackedVector3Array p_normals;
-	p_normals.resize(final_normals.size());
-	if (!final_normals.empty()) {
-		memcpy(p_normals.ptrw(), final_normals.data(), final_normals.size() * sizeof(Vector3));
+	PackedInt32Array tri_voxel_info;
+	tri_voxel_info.resize(out.tri_voxel_info.size());
+	if (!out.tri_voxel_info.empty()) {
+		memcpy(tri_voxel_info.ptrw(), out.tri_voxel_info.data(), out.tri_voxel_info.size() * sizeof(int32_t));
 	}
 
-	PackedColorArray p_colors;
-	p_colors.resize(final_normals_smoothed.size());
-	if (!final_normals_smoothed.empty()) {
-		memcpy(p_colors.ptrw(), final_normals_smoothed.data(), final_normals_smoothed.size() * sizeof(Color));
+	Dictionary result;
+	result["arraymesh"] = _build_array_mesh(out, compress_attributes);
+	result["tri_voxel_info"] = tri_voxel_info;
+	return result;
+}
+
+// Pads p_out with zero-area triangles collapsed onto p_pos
+static void append_degenerate_vertices(std::vector<Vector3> &r_vertices, std::vector<Vector3> &r_normals,
+		std::vector<Color> &r_colors, std::vector<Vector2> &r_uvs, int p_count, const Vector3 &p_pos) {
+	r_vertices.insert(r_vertices.end(), p_count, p_pos);
+	r_normals.insert(r_normals.end(), p_count, Vector3(0, 1, 0));
+	r_colors.insert(r_colors.end(), p_count, Color(0, 0, 0));
+	r_uvs.insert(r_uvs.end(), p_count, Vector2());
+}
+
+void VoxelMesher::_build_patchable(const VoxelChunkData &p_chunk, const ChunkApron *p_apron, PatchState &r_state) {
+	ChunkInput input;
+	_fill_chunk_input(p_chunk, input);
+	input.layers_vis = r_state.layers_vis.data();
+	input.layer_count = (int)r_state.layers_vis.size();
+	input.apron = p_apron;
+	input.flat_output = true;
+
+	MeshOutput &out = main_output;
+	_mesh_chunk(input, main_scratch, out);
+
+	// Slots follow emission order: each voxel's triangles are contiguous
+	const Vector3i origin(input.chunk_coord.x * input.size_x, input.chunk_coord.y * input.size_y, input.chunk_coord.z * input.size_z);
+	r_state.size = Vector3i(input.size_x, input.size_y, input.size_z);
+	r_state.slots.assign((size_t)input.size_x * input.size_y * input.size_z, PatchSlot());
+	const int tri_count = (int)out.tri_voxel_info.size() / 2;
+	for (int tri = 0; tri < tri_count;) {
+		const int32_t voxel_index = out.tri_voxel_info[tri * 2];
+		int run_end = tri + 1;
+		while (run_end < tri_count && out.tri_voxel_info[run_end * 2] == voxel_index) {
+			run_end++;
+		}
+		const Vector3i local = input.voxels[voxel_index] - origin;
+		PatchSlot &slot = r_state.slots[local.x + local.y * input.size_x + local.z * input.size_x * input.size_y];
+		slot.first_vertex = tri * 3;
+		slot.capacity = (run_end - tri) * 3;
+		slot.voxel_index = voxel_index;
+		tri = run_end;
 	}
 
-	PackedVector2Array p_uvs;
-	p_uvs.resize(final_uvs.size());
-	if (!final_uvs.empty()) {
-		memcpy(p_uvs.ptrw(), final_uvs.data(), final_uvs.size() * sizeof(Vector2));
+	// Spare space for voxels that gain faces, a quarter of the mesh but at least 512 triangles
+	const int32_t used = (int32_t)out.vertices.size();
+	const int32_t spare = MAX(used / 12, 512) * 3;
+	const Vector3 pad_pos((float)origin.x, (float)origin.y, (float)origin.z);
+	append_degenerate_vertices(out.vertices, out.normals, out.normals_smoothed, out.uvs, spare, pad_pos);
+	r_state.tri_voxel_info = out.tri_voxel_info;
+	r_state.tri_voxel_info.resize(out.tri_voxel_info.size() + spare / 3 * 2, -1);
+	r_state.vertex_capacity = used + spare;
+	r_state.tail = used;
+	r_state.abandoned = 0;
+	r_state.config_generation = mesh_config_generation;
+
+	// Same ArrayMesh across rebuilds, so nodes holding it stay valid
+	if (r_state.mesh.is_null()) {
+		r_state.mesh.instantiate();
 	}
+	r_state.mesh->clear_surfaces();
+	r_state.mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, _make_surface_arrays(out));
+	r_state.format = (uint64_t)r_state.mesh->surface_get_format(0);
 
-	Array mesh_arrays;
-	mesh_arrays.resize(Mesh::ARRAY_MAX);
-	mesh_arrays[Mesh::ARRAY_VERTEX] = p_vertices;
-	mesh_arrays[Mesh::ARRAY_NORMAL] = p_normals;
-	mesh_arrays[Mesh::ARRAY_COLOR] = p_colors;
-	mesh_arrays[Mesh::ARRAY_TEX_UV] = p_uvs;
+	// The surface AABB is fixed at creation; cover anything a patch can add
+	// (shape vertices reach 0.5 past the voxel centre, wobble another 0.1)
+	r_state.mesh->set_custom_aabb(AABB(pad_pos - Vector3(1, 1, 1), Vector3((float)input.size_x + 2, (float)input.size_y + 2, (float)input.size_z + 2)));
+}
+
+bool VoxelMesher::_upload_patch(PatchState &r_state, int32_t p_first_vertex, int32_t p_capacity, const MeshOutput &p_src,
+		int32_t p_src_first, int32_t p_count, const Vector3 &p_pad_pos) {
+	MeshOutput &region = patch_output;
+	region.vertices.assign(p_src.vertices.begin() + p_src_first, p_src.vertices.begin() + p_src_first + p_count);
+	region.normals.assign(p_src.normals.begin() + p_src_first, p_src.normals.begin() + p_src_first + p_count);
+	region.normals_smoothed.assign(p_src.normals_smoothed.begin() + p_src_first, p_src.normals_smoothed.begin() + p_src_first + p_count);
+	region.uvs.assign(p_src.uvs.begin() + p_src_first, p_src.uvs.begin() + p_src_first + p_count);
+	region.indices.clear();
+	append_degenerate_vertices(region.vertices, region.normals, region.normals_smoothed, region.uvs, p_capacity - p_count, p_pad_pos);
+
+	for (int32_t v = 0; v < p_capacity; v += 3) {
+		const int32_t dst = (p_first_vertex + v) / 3 * 2;
+		if (v < p_count) {
+			r_state.tri_voxel_info[dst] = p_src.tri_voxel_info[(p_src_first + v) / 3 * 2];
+			r_state.tri_voxel_info[dst + 1] = p_src.tri_voxel_info[(p_src_first + v) / 3 * 2 + 1];
+		} else {
+			r_state.tri_voxel_info[dst] = -1;
+			r_state.tri_voxel_info[dst + 1] = -1;
+		}
+	}
+
+	// Let the engine encode the range in the surface's own layout
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const Dictionary surface = rs->mesh_create_surface_data_from_arrays(RenderingServer::PRIMITIVE_TRIANGLES, _make_surface_arrays(region));
+	const PackedByteArray vertex_data = surface.get("vertex_data", PackedByteArray());
+	const PackedByteArray attribute_data = surface.get("attribute_data", PackedByteArray());
+	// Uncompressed surfaces hold every position first and the normals after
+	// them, so a range is two separate writes into the vertex buffer
+	const int64_t vertex_stride = rs->mesh_surface_get_format_vertex_stride(r_state.format, r_state.vertex_capacity);
+	const int64_t normal_stride = rs->mesh_surface_get_format_normal_tangent_stride(r_state.format, r_state.vertex_capacity);
+	const int64_t attribute_stride = rs->mesh_surface_get_format_attribute_stride(r_state.format, r_state.vertex_capacity);
+	const int64_t normal_offset = rs->mesh_surface_get_format_offset(r_state.format, r_state.vertex_capacity, Mesh::ARRAY_NORMAL);
+	const int64_t region_normal_offset = rs->mesh_surface_get_format_offset(r_state.format, p_capacity, Mesh::ARRAY_NORMAL);
+	if (vertex_data.size() != (vertex_stride + normal_stride) * p_capacity || attribute_data.size() != attribute_stride * p_capacity ||
+			region_normal_offset != vertex_stride * p_capacity) {
+		ERR_PRINT("patch_chunk_mesh: surface layout mismatch, rebuilding");
+		return false;
+	}
+	r_state.mesh->surface_update_vertex_region(0, (int32_t)(vertex_stride * p_first_vertex), vertex_data.slice(0, region_normal_offset));
+	r_state.mesh->surface_update_vertex_region(0, (int32_t)(normal_offset + normal_stride * p_first_vertex), vertex_data.slice(region_normal_offset));
+	r_state.mesh->surface_update_attribute_region(0, (int32_t)(attribute_stride * p_first_vertex), attribute_data);
+	return true;
+}
 
-	array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, mesh_arrays);
+Dictionary VoxelMesher::_patch_result(const PatchState &p_state, bool p_rebuilt) {
+	PackedInt32Array tri_voxel_info;
+	tri_voxel_info.resize(p_state.tri_voxel_info.size());
+	if (!p_state.tri_voxel_info.empty()) {
+		memcpy(tri_voxel_info.ptrw(), p_state.tri_voxel_info.data(), p_state.tri_voxel_info.size() * sizeof(int32_t));
+	}
 
 	Dictionary result;
-	result["arraymesh"] = array_mesh;
+	result["arraymesh"] = p_state.mesh;
 	result["tri_voxel_info"] = tri_voxel_info;
-	
+	result["rebuilt"] = p_rebuilt;
 	return result;
 }
 
-Ref<ArrayMesh> VoxelMesher::generate_simplified_mesh(
-		const Vector3i &chunk_coord,
-		const Array &voxels,
-		int size_x, int size_y, int size_z) {
+Dictionary VoxelMesher::generate_patchable_chunk_mesh(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const Array &neighbours) {
 
-	int limit_x = size_x;
-	int limit_y = size_y;
-	int limit_z = size_z;
+	if (chunk_data.is_null()) {
+		ERR_PRINT("generate_patchable_chunk_mesh: chunk_data is null");
+		return Dictionary();
+	}
 
-	std::vector<uint8_t> solid_array(limit_x * limit_y * limit_z, 0);
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+	PatchState &state = patch_states[input.chunk_coord];
+	_unpack_layer_visibility(layer_visibility, state.layers_vis);
+	input.layers_vis = state.layers_vis.data();
+	input.layer_count = (int)state.layers_vis.size();
+
+	ChunkApron apron;
+	ChunkApron *apron_ptr = nullptr;
+	if (!neighbours.is_empty()) {
+		_build_apron_from_array(neighbours, input, apron);
+		apron_ptr = &apron;
+	}
 
-	Vector3i offset(chunk_coord.x * size_x, chunk_coord.y * size_y, chunk_coord.z * size_z);
+	_build_patchable(*chunk_data.ptr(), apron_ptr, state);
+	return _patch_result(state, true);
+}
 
-	int stride_x = 1;
-	int stride_y = limit_x;
-	int stride_z = limit_x * limit_y;
-	int strides[3] = {stride_x, stride_y, stride_z};
+Dictionary VoxelMesher::patch_chunk_mesh(
+		const Ref<VoxelChunkData> &chunk_data,
+		const TypedArray<Vector3i> &edited_voxels,
+		const Array &neighbours) {
 
-	int voxel_count = voxels.size();
-	for (int i = 0; i < voxel_count; i++) {
-		Vector3i v = voxels[i];
-		int lx = v.x - offset.x;
-		int ly = v.y - offset.y;
-		int lz = v.z - offset.z;
+	if (chunk_data.is_null()) {
+		ERR_PRINT("patch_chunk_mesh: chunk_data is null");
+		return Dictionary();
+	}
+
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+	auto state_it = patch_states.find(input.chunk_coord);
+	if (state_it == patch_states.end()) {
+		ERR_PRINT("patch_chunk_mesh: chunk was not built with generate_patchable_chunk_mesh");
+		return Dictionary();
+	}
+	PatchState &state = state_it->second;
+	input.layers_vis = state.layers_vis.data();
+	input.layer_count = (int)state.layers_vis.size();
+
+	ChunkApron apron;
+	if (!neighbours.is_empty()) {
+		_build_apron_from_array(neighbours, input, apron);
+		input.apron = &apron;
+	}
+
+	std::vector<Vector3i> edited(edited_voxels.size());
+	for (int i = 0; i < edited_voxels.size(); i++) {
+		edited[i] = edited_voxels[i];
+	}
+
+	// Out of spare space, or too much of the surface is dead padding: compact
+	if (!_patch_voxels(input, edited, state) || state.abandoned > state.vertex_capacity / 2) {
+		_build_patchable(*chunk_data.ptr(), input.apron, state);
+		return _patch_result(state, true);
+	}
+	return _patch_result(state, false);
+}
+
+bool VoxelMesher::_patch_voxels(ChunkInput &p_input, const std::vector<Vector3i> &p_edited, PatchState &r_state) {
+	const int size_x = p_input.size_x;
+	const int size_y = p_input.size_y;
+	const int size_z = p_input.size_z;
+	// Patching a surface built with other shapes or seeds would mix the two
+	if (r_state.size != Vector3i(size_x, size_y, size_z) || r_state.config_generation != mesh_config_generation) {
+		return false;
+	}
+
+	// Cells whose faces can change: every edited cell and its six neighbours
+	const Vector3i origin(p_input.chunk_coord.x * size_x, p_input.chunk_coord.y * size_y, p_input.chunk_coord.z * size_z);
+	std::vector<int32_t> cells;
+	for (const Vector3i &pos : p_edited) {
+		const Vector3i local = pos - origin;
+		for (int dir = -1; dir < 6; dir++) {
+			const Vector3i cell = dir < 0 ? local : local + DIR_OFFSETS[dir];
+			if ((unsigned)cell.x < (unsigned)size_x && (unsigned)cell.y < (unsigned)size_y && (unsigned)cell.z < (unsigned)size_z) {
+				cells.push_back(cell.x + cell.y * size_x + cell.z * size_x * size_y);
+			}
+		}
+	}
+	std::sort(cells.begin(), cells.end());
+	cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+	std::vector<int32_t> subset;
+	for (int32_t cell : cells) {
+		if (p_input.voxel_grid[cell] != -1) {
+			subset.push_back(p_input.voxel_grid[cell]);
+		}
+	}
+	p_input.flat_output = true;
+	p_input.voxel_subset = subset.data();
+	p_input.voxel_subset_count = (int)subset.size();
+
+	MeshOutput &out = main_output;
+	_mesh_chunk(p_input, main_scratch, out);
+
+	// Emitted range of each subset voxel (voxels with no visible face emit nothing)
+	std::unordered_map<int32_t, std::pair<int32_t, int32_t>> emitted; // voxel -> (first vertex, count)
+	const int tri_count = (int)out.tri_voxel_info.size() / 2;
+	for (int tri = 0; tri < tri_count;) {
+		const int32_t voxel_index = out.tri_voxel_info[tri * 2];
+		int run_end = tri + 1;
+		while (run_end < tri_count && out.tri_voxel_info[run_end * 2] == voxel_index) {
+			run_end++;
+		}
+		emitted[voxel_index] = std::make_pair(tri * 3, (run_end - tri) * 3);
+		tri = run_end;
+	}
+
+	const Vector3 pad_pos((float)origin.x, (float)origin.y, (float)origin.z);
+	bool ok = true;
+	for (int32_t cell : cells) {
+		if (!ok) {
+			break;
+		}
+		PatchSlot &slot = r_state.slots[cell];
+		const int32_t voxel_index = p_input.voxel_grid[cell];
+		int32_t src_first = 0;
+		int32_t count = 0;
+		auto it = emitted.find(voxel_index);
+		if (voxel_index != -1 && it != emitted.end()) {
+			src_first = it->second.first;
+			count = it->second.second;
+		}
+		slot.voxel_index = voxel_index;
+
+		if (count <= slot.capacity) {
+			if (slot.capacity > 0) {
+				ok = _upload_patch(r_state, slot.first_vertex, slot.capacity, out, src_first, count, pad_pos);
+			}
+			continue;
+		}
+
+		// Outgrew the slot: blank it and take fresh space from the tail
+		if (slot.capacity > 0) {
+			ok = _upload_patch(r_state, slot.first_vertex, slot.capacity, out, 0, 0, pad_pos);
+			r_state.abandoned += slot.capacity;
+		}
+		if (r_state.tail + count > r_state.vertex_capacity) {
+			ok = false;
+			break;
+		}
+		slot.first_vertex = r_state.tail;
+		slot.capacity = count;
+		r_state.tail += count;
+		ok = ok && _upload_patch(r_state, slot.first_vertex, slot.capacity, out, src_first, count, pad_pos);
+	}
+
+	// Swap-remove moved the chunk's last voxel into the removed one's index;
+	// retarget its triangles. Cheap compared to meshing: one compare per cell.
+	if (ok) {
+		for (size_t cell = 0; cell < r_state.slots.size(); cell++) {
+			PatchSlot &slot = r_state.slots[cell];
+			if (slot.capacity == 0 || slot.voxel_index == -1 || p_input.voxel_grid[cell] == slot.voxel_index) {
+				continue;
+			}
+			const int32_t voxel_index = p_input.voxel_grid[cell];
+			if (voxel_index == -1) {
+				// Removed without being listed in edited_voxels
+				ok = _upload_patch(r_state, slot.first_vertex, slot.capacity, out, 0, 0, pad_pos);
+			} else {
+				for (int32_t v = 0; v < slot.capacity; v += 3) {
+					int32_t &entry = r_state.tri_voxel_info[(slot.first_vertex + v) / 3 * 2];
+					if (entry != -1) {
+						entry = voxel_index;
+					}
+				}
+			}
+			slot.voxel_index = voxel_index;
+		}
+	}
+	return ok;
+}
+
+void VoxelMesher::release_patchable_chunk(const Vector3i &chunk_coord) {
+	patch_states.erase(chunk_coord);
+}
+
+Dictionary VoxelMesher::generate_chunk_mesh_to_rid(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const RID &mesh_rid,
+		const Array &neighbours) {
+
+	if (chunk_data.is_null()) {
+		ERR_PRINT("generate_chunk_mesh_to_rid: chunk_data is null");
+		return Dictionary();
+	}
+
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+	input.layers_vis = layers_vis.data();
+	input.layer_count = (int)layers_vis.size();
+
+	ChunkApron apron;
+	if (!neighbours.is_empty()) {
+		_build_apron_from_array(neighbours, input, apron);
+		input.apron = &apron;
+	}
+
+	_mesh_chunk(input, main_scratch, main_output);
+
+	// Reuse the chunk's mesh when it has one; the surface goes in already in
+	// GPU layout, so the engine only uploads it
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID rid = mesh_rid;
+	if (rid.is_valid()) {
+		rs->mesh_clear(rid);
+	} else {
+		rid = rs->mesh_create();
+	}
+	if (!main_output.vertices.empty()) {
+		rs->mesh_add_surface(rid, _make_surface_data(main_output));
+	}
+
+	Dictionary result;
+	result["mesh_rid"] = rid;
+	_store_picking_info(main_output, result);
+	return result;
+}
+
+TypedArray<Dictionary> VoxelMesher::generate_chunk_meshes_batch(
+		const TypedArray<VoxelChunkData> &chunks,
+		const Array &layer_visibility,
+		bool cull_chunk_borders) {
+
+	const int chunk_count = chunks.size();
+	TypedArray<Dictionary> results;
+	results.resize(chunk_count);
+	if (chunk_count == 0) {
+		return results;
+	}
+
+	// Everything the workers read is converted up front on this thread - the
+	// workers never touch a Variant. Holding the Refs keeps the chunks alive.
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+
+	std::vector<Ref<VoxelChunkData>> chunk_refs(chunk_count);
+	BatchJob job;
+	job.inputs.resize(chunk_count);
+	job.outputs.resize(chunk_count);
+	for (int i = 0; i < chunk_count; i++) {
+		chunk_refs[i] = chunks[i];
+		ChunkInput &input = job.inputs[i];
+		if (chunk_refs[i].is_valid()) {
+			_fill_chunk_input(*chunk_refs[i].ptr(), input);
+		} else {
+			input.voxel_count = 0;
+		}
+		input.layers_vis = layers_vis.data();
+		input.layer_count = (int)layers_vis.size();
+	}
+
+	// Neighbours are looked up among the chunks of this batch
+	std::vector<ChunkApron> aprons;
+	if (cull_chunk_borders) {
+		std::map<Vector3i, const VoxelChunkData *> by_coord;
+		for (int i = 0; i < chunk_count; i++) {
+			if (chunk_refs[i].is_valid()) {
+				by_coord[chunk_refs[i]->get_chunk_coord()] = chunk_refs[i].ptr();
+			}
+		}
+		aprons.resize(chunk_count);
+		for (int i = 0; i < chunk_count; i++) {
+			if (chunk_refs[i].is_null()) {
+				continue;
+			}
+			const Vector3i coord = chunk_refs[i]->get_chunk_coord();
+			const VoxelChunkData *neighbour_ptrs[6] = {};
+			for (int dir = 0; dir < 6; dir++) {
+				auto it = by_coord.find(coord + DIR_OFFSETS[dir]);
+				if (it != by_coord.end()) {
+					neighbour_ptrs[dir] = it->second;
+				}
+			}
+			_build_apron(job.inputs[i], neighbour_ptrs, aprons[i]);
+			job.inputs[i].apron = &aprons[i];
+		}
+	}
+
+	// One group task element per chunk; WorkerThreadPool spreads them over its threads
+	active_batch = &job;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const int64_t group_id = pool->add_group_task(callable_mp(this, &VoxelMesher::_batch_mesh_element),
+		chunk_count, -1, true, "VoxelMesher batch");
+	pool->wait_for_group_task_completion(group_id);
+	active_batch = nullptr;
+
+	// ArrayMesh creation stays on the calling thread, in input order
+	for (int i = 0; i < chunk_count; i++) {
+		if (chunk_refs[i].is_null()) {
+			results[i] = Dictionary();
+			continue;
+		}
+		results[i] = _make_mesh_result(job.outputs[i]);
+	}
+	return results;
+}
+
+void VoxelMesher::_batch_mesh_element(uint32_t p_index) {
+	BatchJob *job = active_batch;
+	MeshScratch *scratch = _acquire_scratch();
+	_mesh_chunk(job->inputs[p_index], *scratch, job->outputs[p_index]);
+	_release_scratch(scratch);
+}
+
+VoxelMesher::MeshScratch *VoxelMesher::_acquire_scratch() {
+	std::lock_guard<std::mutex> lock(scratch_pool_mutex);
+	if (scratch_pool.empty()) {
+		return new MeshScratch();
+	}
+	MeshScratch *scratch = scratch_pool.back().release();
+	scratch_pool.pop_back();
+	return scratch;
+}
+
+void VoxelMesher::_release_scratch(MeshScratch *p_scratch) {
+	std::lock_guard<std::mutex> lock(scratch_pool_mutex);
+	scratch_pool.emplace_back(p_scratch);
+}
+
+void VoxelMesher::_fill_chunk_input(const VoxelChunkData &p_data, ChunkInput &r_input) {
+	r_input.chunk_coord = p_data.get_chunk_coord();
+	r_input.voxels = p_data.get_positions_ptr();
+	r_input.voxel_props = p_data.get_records_ptr();
+	r_input.voxel_count = p_data.get_voxel_count();
+	r_input.voxel_grid = p_data.get_index_grid_ptr();
+	r_input.size_x = p_data.get_size_x();
+	r_input.size_y = p_data.get_size_y();
+	r_input.size_z = p_data.get_size_z();
+}
+
+void VoxelMesher::_unpack_layer_visibility(const Array &p_layer_visibility, std::vector<uint8_t> &r_layers_vis) {
+	const int layer_count = p_layer_visibility.size();
+	r_layers_vis.resize(layer_count);
+	for (int i = 0; i < layer_count; ++i) {
+		r_layers_vis[i] = (bool)p_layer_visibility[i] ? 1 : 0;
+	}
+}
+
+int32_t VoxelMesher::_weld_vertex(MeshScratch &scratch, MeshOutput &out, int vertex_index,
+		const Vector3 &voxel_pos, const Vector3 &normal, const Vector2 &uv) {
+	// Bucketed by shape vertex index: position and colour only depend on it,
+	// so a chain only has to compare normal and UV
+	for (int32_t e = scratch.weld_heads[vertex_index]; e != -1; e = scratch.weld_entries[e].next) {
+		const WeldEntry &entry = scratch.weld_entries[e];
+		if (entry.normal == normal && entry.uv == uv) {
+			return entry.out_index;
+		}
+	}
+
+	const int32_t out_index = (int32_t)out.vertices.size();
+	out.vertices.push_back(scratch.cached_wobbled_local_verts[vertex_index] + voxel_pos);
+	out.normals_smoothed.push_back(scratch.cached_vertex_colors[vertex_index]);
+	out.normals.push_back(normal);
+	out.uvs.push_back(uv);
+
+	WeldEntry entry;
+	entry.next = scratch.weld_heads[vertex_index];
+	entry.out_index = out_index;
+	entry.normal = normal;
+	entry.uv = uv;
+	scratch.weld_heads[vertex_index] = (int32_t)scratch.weld_entries.size();
+	scratch.weld_entries.push_back(entry);
+	return out_index;
+}
+
+void VoxelMesher::_build_apron_from_array(const Array &p_neighbours, const ChunkInput &p_input, ChunkApron &r_apron) const {
+	// The Array keeps the chunks alive for the call, the Refs only unwrap them
+	const VoxelChunkData *neighbour_ptrs[6] = {};
+	Ref<VoxelChunkData> neighbour_refs[6];
+	for (int dir = 0; dir < 6 && dir < p_neighbours.size(); dir++) {
+		neighbour_refs[dir] = p_neighbours[dir];
+		neighbour_ptrs[dir] = neighbour_refs[dir].ptr();
+	}
+	_build_apron(p_input, neighbour_ptrs, r_apron);
+}
+
+void VoxelMesher::_build_apron(const ChunkInput &p_input, const VoxelChunkData *const p_neighbours[6], ChunkApron &r_apron) const {
+	const int sx = p_input.size_x;
+	const int sy = p_input.size_y;
+	const int sz = p_input.size_z;
+	r_apron.size_x = sx;
+	r_apron.size_y = sy;
+	r_apron.size_z = sz;
+
+	for (int dir = 0; dir < 6; dir++) {
+		std::vector<int16_t> &layer = r_apron.faces[dir];
+		layer.clear();
+		const VoxelChunkData *neighbour = p_neighbours[dir];
+		// Chunks of another size can't line up cell for cell - leave that side open
+		if (neighbour == nullptr || neighbour->get_size_x() != sx || neighbour->get_size_y() != sy || neighbour->get_size_z() != sz) {
+			continue;
+		}
+
+		// The neighbour's cells touching our boundary: its first layer when it sits
+		// on the positive side, its last layer when it sits on the negative side
+		const Vector3i &d = DIR_OFFSETS[dir];
+		const int fixed = (d.x + d.y + d.z) > 0 ? 0 : (d.x != 0 ? sx : (d.y != 0 ? sy : sz)) - 1;
+		const int32_t *grid = neighbour->get_index_grid_ptr();
+		const VoxelData *records = neighbour->get_records_ptr();
+
+		// Layer is indexed (a + b * dim_a) with a, b the two axes other than d
+		int dim_a, dim_b;
+		if (d.z != 0) {
+			dim_a = sx;
+			dim_b = sy;
+		} else if (d.x != 0) {
+			dim_a = sy;
+			dim_b = sz;
+		} else {
+			dim_a = sx;
+			dim_b = sz;
+		}
+		layer.resize(dim_a * dim_b);
+
+		for (int b = 0; b < dim_b; b++) {
+			for (int a = 0; a < dim_a; a++) {
+				int x, y, z;
+				if (d.z != 0) {
+					x = a; y = b; z = fixed;
+				} else if (d.x != 0) {
+					x = fixed; y = a; z = b;
+				} else {
+					x = a; y = fixed; z = b;
+				}
+				int16_t key = -1;
+				const int32_t index = grid[x + y * sx + z * sx * sy];
+				if (index != -1) {
+					const VoxelData &props = records[index];
+					if ((unsigned)props.layer < (unsigned)p_input.layer_count && p_input.layers_vis[props.layer]) {
+						const uint8_t lookup_key = ((uint8_t)props.shape_type) | ((uint8_t)props.rot << 4) | ((props.vflip ? 1 : 0) << 6);
+						if (shape_lookup_valid[lookup_key]) {
+							key = (int16_t)(lookup_key | (props.layer << 8));
+						}
+					}
+				}
+				layer[a + b * dim_a] = key;
+			}
+		}
+	}
+}
+
+void VoxelMesher::_mesh_chunk(const ChunkInput &in, MeshScratch &scratch, MeshOutput &out) const {
+	std::shared_lock<std::shared_mutex> config_lock(config_mutex);
+	out.config_generation = mesh_config_generation;
+
+	const int voxel_count = in.voxel_count;
+	const int size_x = in.size_x;
+	const int size_y = in.size_y;
+	const int size_z = in.size_z;
+
+	// Clear output buffers (memory stays allocated)
+	out.vertices.clear();
+	out.normals.clear();
+	out.normals_smoothed.clear();
+	out.uvs.clear();
+	out.tri_voxel_info.clear();
+	out.indices.clear();
+	out.face_runs.clear();
+	out.tri_groups.clear();
+
+	const bool split_layers = in.split_layers;
+	const bool flat_output = in.flat_output || split_layers;
+	const bool use_face_runs = face_runs_output && !flat_output;
+	out.has_face_runs = use_face_runs;
+
+	// Early exit for empty chunks
+	if (voxel_count == 0) {
+		return;
+	}
+
+	// Face runs go into a scratch buffer sized for the worst case (every face of
+	// every voxel emitted, plus the sentinel) and written by cursor - no growth
+	// and no clearing in the loop
+	int32_t *face_run_cursor = nullptr;
+	int32_t triangle_count = 0;
+	if (use_face_runs) {
+		const size_t needed = ((size_t)voxel_count * max_template_faces + 1) * 2;
+		if (scratch.face_run_capacity < needed) {
+			scratch.face_run_buffer.reset(new int32_t[needed]);
+			scratch.face_run_capacity = needed;
+		}
+		face_run_cursor = scratch.face_run_buffer.get();
+	}
+
+	// Reserve space if needed (only grows, never shrinks)
+	const int reserve_size = voxel_count * 32;
+	if ((int)out.vertices.capacity() < reserve_size) {
+		out.vertices.reserve(reserve_size);
+		out.normals.reserve(reserve_size);
+		out.normals_smoothed.reserve(reserve_size);
+		out.uvs.reserve(reserve_size);
+		out.tri_voxel_info.reserve(reserve_size / 3 * 2);
+	}
+
+	const Vector3i offset(in.chunk_coord.x * size_x, in.chunk_coord.y * size_y, in.chunk_coord.z * size_z);
+	const int stride_y = size_x;
+	const int stride_z = size_x * size_y;
+
+	// Grid Cache - skipped entirely when the caller already owns an index grid
+	const int32_t *grid = in.voxel_grid;
+	if (grid == nullptr) {
+		// Resize only if dimensions changed (they're constant, so this happens once)
+		const int grid_size = size_x * size_y * size_z;
+		if (scratch.cached_size_x != size_x || scratch.cached_size_y != size_y || scratch.cached_size_z != size_z) {
+			scratch.grid_cache.resize(grid_size);
+			scratch.cached_size_x = size_x;
+			scratch.cached_size_y = size_y;
+			scratch.cached_size_z = size_z;
+		}
+
+		// Clear grid cache (fill with -1)
+		std::fill(scratch.grid_cache.begin(), scratch.grid_cache.end(), -1);
+
+		// Populate grid cache - optimized bounds checking with single comparison
+		for (int i = 0; i < voxel_count; i++) {
+			const Vector3i &v = in.voxels[i];
+			const int lx = v.x - offset.x;
+			const int ly = v.y - offset.y;
+			const int lz = v.z - offset.z;
+
+			// Single bounds check using unsigned comparison trick
+			if ((unsigned)lx < (unsigned)size_x &&
+			    (unsigned)ly < (unsigned)size_y &&
+			    (unsigned)lz < (unsigned)size_z) {
+				scratch.grid_cache[lx + ly * stride_y + lz * stride_z] = i;
+			}
+		}
+		grid = scratch.grid_cache.data();
+	}
+
+	// ALGORITHMIC OPTIMIZATION: Pre-cache shape variant pointers to avoid repeated lookups
+	// Reuse scratch buffer
+	std::vector<CachedVoxelInfo> &voxel_cache = scratch.voxel_cache;
+	voxel_cache.clear();
+	voxel_cache.resize(voxel_count);
+
+	// Pre-cache all shape variants (one-time cost, eliminates repeated 3-level lookups)
+	for (int voxel_index = 0; voxel_index < voxel_count; voxel_index++) {
+		const VoxelData &props = in.voxel_props[voxel_index];
+		CachedVoxelInfo &cache_entry = voxel_cache[voxel_index];
+
+		// Early exit for invisible layers
+		if ((unsigned)props.layer >= (unsigned)in.layer_count || !in.layers_vis[props.layer]) {
+			cache_entry.valid = false;
+			continue;
+		}
+
+		// Validate and cache shape access using direct array lookup - single byte key!
+		// Encoding: shape_type | (rotation << 4) | (vflip << 6) - fits in 8 bits
+		uint8_t lookup_key = ((uint8_t)props.shape_type) | ((uint8_t)props.rot << 4) | ((props.vflip ? 1 : 0) << 6);
+
+		// Direct array access - O(1) with zero hash overhead!
+		if (!shape_lookup_valid[lookup_key]) {
+			cache_entry.valid = false;
+			continue;
+		}
+
+		// Cache the shape variant pointer - direct array access, fastest possible lookup!
+		cache_entry.shape_ptr = shape_lookup_array[lookup_key];
+		cache_entry.lookup_key = lookup_key; // Store for direct face occupancy cache access
+		cache_entry.voxel_pos = in.voxels[voxel_index];
+		cache_entry.local_x = cache_entry.voxel_pos.x - offset.x;
+		cache_entry.local_y = cache_entry.voxel_pos.y - offset.y;
+		cache_entry.local_z = cache_entry.voxel_pos.z - offset.z;
+		cache_entry.in_chunk = (unsigned)cache_entry.local_x < (unsigned)size_x &&
+				(unsigned)cache_entry.local_y < (unsigned)size_y &&
+				(unsigned)cache_entry.local_z < (unsigned)size_z;
+		cache_entry.valid = true;
+	}
+
+	// Face visibility pre-pass, one 64-bit word per x row (row = y + z * size_y).
+	// A face is certainly hidden when it fits inside a QUAD and the neighbour's
+	// opposite face is a QUAD; it is certainly open when the in-chunk neighbour
+	// cell is empty. Everything else (partial neighbours, chunk borders) goes
+	// through occupancy_fits_table as before, and so do voxels outside the chunk.
+	const bool use_face_bits = size_x <= 64 && in.voxel_subset == nullptr;
+	const int row_count = size_y * size_z;
+	const uint64_t *hidden_bits = nullptr;
+	const uint64_t *open_bits = nullptr;
+	if (use_face_bits) {
+		std::vector<uint64_t> &bits = scratch.face_bits;
+		// [0] present, [1..6] QUAD per dir, [7..12] fits-in-QUAD per dir, [13..18] hidden, [19..24] open
+		bits.assign((size_t)row_count * 25, 0);
+		uint64_t *present = bits.data();
+		uint64_t *quad = present + row_count;
+		uint64_t *fits = quad + row_count * 6;
+		uint64_t *hidden = fits + row_count * 6;
+		uint64_t *open = hidden + row_count * 6;
+
+		for (int voxel_index = 0; voxel_index < voxel_count; voxel_index++) {
+			const CachedVoxelInfo &cache_entry = voxel_cache[voxel_index];
+			if (!cache_entry.valid || !cache_entry.in_chunk) {
+				continue;
+			}
+			const int row = cache_entry.local_y + cache_entry.local_z * size_y;
+			const uint64_t bit = (uint64_t)1 << cache_entry.local_x;
+			present[row] |= bit;
+			const ShapeVariant &shape_data = *cache_entry.shape_ptr;
+			for (int dir = 0; dir < 6 && dir < (int)shape_data.faces.size(); dir++) {
+				const FaceData &face = shape_data.faces[dir];
+				if (face.face_occupancy == OCCUPANCY_QUAD) {
+					quad[dir * row_count + row] |= bit;
+				}
+				if (face.occupy_face && face.face_occupancy >= OCCUPANCY_TRI0 && face.face_occupancy <= OCCUPANCY_QUAD) {
+					fits[dir * row_count + row] |= bit;
+				}
+			}
+		}
+
+		const uint64_t row_mask = size_x == 64 ? ~(uint64_t)0 : (((uint64_t)1 << size_x) - 1);
+		for (int dir = 0; dir < 6; dir++) {
+			const uint64_t *neigh_quad = quad + OPPOSITE_DIR[dir] * row_count;
+			const int row_step = DIR_OFFSETS[dir].y + DIR_OFFSETS[dir].z * size_y;
+			for (int z = 0; z < size_z; z++) {
+				for (int y = 0; y < size_y; y++) {
+					const int row = y + z * size_y;
+					const int ny = y + DIR_OFFSETS[dir].y;
+					const int nz = z + DIR_OFFSETS[dir].z;
+					if ((unsigned)ny >= (unsigned)size_y || (unsigned)nz >= (unsigned)size_z) {
+						continue; // Whole row borders the next chunk
+					}
+					uint64_t nq = neigh_quad[row + row_step];
+					uint64_t np = present[row + row_step];
+					uint64_t in_bounds = row_mask;
+					// Along x the neighbour is the adjacent bit of the same row
+					if (DIR_OFFSETS[dir].x > 0) {
+						nq >>= 1;
+						np >>= 1;
+						in_bounds = row_mask >> 1;
+					} else if (DIR_OFFSETS[dir].x < 0) {
+						nq <<= 1;
+						np <<= 1;
+						in_bounds = (row_mask << 1) & row_mask;
+					}
+					hidden[dir * row_count + row] = fits[dir * row_count + row] & nq & in_bounds;
+					open[dir * row_count + row] = present[row] & ~np & in_bounds;
+				}
+			}
+		}
+		hidden_bits = hidden;
+		open_bits = open;
+	}
+
+	// Temporary buffers - reuse scratch buffers (cleared per voxel)
+	std::vector<Vector3> &cached_wobbled_local_verts = scratch.cached_wobbled_local_verts;
+	std::vector<Color> &cached_vertex_colors = scratch.cached_vertex_colors;
+	cached_wobbled_local_verts.clear();
+	cached_vertex_colors.clear();
+	if (cached_wobbled_local_verts.capacity() < 512) {
+		cached_wobbled_local_verts.reserve(512);
+		cached_vertex_colors.reserve(512);
+	}
+
+	// Use cached noise pointers - no .ptr() calls needed!
+	// FastNoiseLite sampling is const, so sharing these across worker threads is safe
+	const FastNoiseLite *n1 = cached_noise1;
+	const FastNoiseLite *n2 = cached_noise2;
+	const FastNoiseLite *n3 = cached_noise3;
+	const bool use_native_noise = native_noise;
+	const uint32_t NO_KEY = 0xFFFFFFFFu;
+
+	const bool indexed = indexed_output && !flat_output;
+
+	// Pre-compute constants
+	const float noise_scale = 0.1f;
+	const float half_scale = 0.5f;
+	const float norm_threshold = 0.0001f;
+	const float default_color = 0.5f;
+
+	// Wobble cache blocks under the chunk, fetched with one lock of the cache.
+	// Insertions and hit/miss counts are reported once, after the loop.
+	// Voxels outside the chunk (Array callers) do without the cache.
+	const Vector3i block_min = WobbleCache::block_coord(offset);
+	const Vector3i block_max = WobbleCache::block_coord(offset + Vector3i(size_x - 1, size_y - 1, size_z - 1));
+	const int blocks_x = block_max.x - block_min.x + 1;
+	const int blocks_y = block_max.y - block_min.y + 1;
+	std::vector<WobbleCache::BlockRef> &wobble_blocks = scratch.wobble_blocks;
+	std::vector<size_t> &wobble_inserted = scratch.wobble_inserted;
+	wobble_cache.get_blocks(block_min, block_max, wobble_blocks);
+	wobble_inserted.assign(wobble_blocks.size(), 0);
+	uint64_t wobble_hits = 0;
+	uint64_t wobble_misses = 0;
+
+	// Main voxel processing loop - per voxel: cull faces, look up the template, stream it out
+	const int emit_count = in.voxel_subset != nullptr ? in.voxel_subset_count : voxel_count;
+	for (int emit_index = 0; emit_index < emit_count; emit_index++) {
+		const int voxel_index = in.voxel_subset != nullptr ? in.voxel_subset[emit_index] : emit_index;
+		if ((unsigned)voxel_index >= (unsigned)voxel_count) {
+			continue;
+		}
+		const CachedVoxelInfo &cache_entry = voxel_cache[voxel_index];
+
+		// Skip invalid/invisible voxels
+		if (!cache_entry.valid) {
+			continue;
+		}
+
+		const VoxelData &props = in.voxel_props[voxel_index];
+		const ShapeVariant &shape_data = *cache_entry.shape_ptr; // Direct cached access!
+
+		const Vector3 v_vec(cache_entry.voxel_pos.x, cache_entry.voxel_pos.y, cache_entry.voxel_pos.z);
+
+		// Work out which of the six side faces are covered; faces past the sixth
+		// have no neighbour and are always emitted
+		uint32_t hidden_mask = 0;
+		int hider_layers[6] = { -1, -1, -1, -1, -1, -1 }; // split_layers: layer covering each kept face
+		const size_t side_count = MIN(shape_data.faces.size(), (size_t)6);
+		for (size_t face_idx = 0; face_idx < side_count; face_idx++) {
+			const FaceData &face = shape_data.faces[face_idx];
+			if (face.indices.empty()) continue;
+
+			// One bit test settles most faces. In split_layers mode a hidden face
+			// still needs the neighbour's layer, so it takes the slow path.
+			bool known_open = false;
+			if (use_face_bits && cache_entry.in_chunk) {
+				const int row = (int)face_idx * row_count + cache_entry.local_y + cache_entry.local_z * size_y;
+				if (!split_layers && ((hidden_bits[row] >> cache_entry.local_x) & 1)) {
+					hidden_mask |= 1u << face_idx;
+					continue;
+				}
+				known_open = (open_bits[row] >> cache_entry.local_x) & 1;
+			}
+
+			// Neighbor check - optimized with early exits and cached shape access
+			if (!known_open && face.occupy_face && face.face_occupancy != OCCUPANCY_EMPTY) {
+				const Vector3i &dir_offset = DIR_OFFSETS[face_idx];
+				const int nlx = cache_entry.local_x + dir_offset.x;
+				const int nly = cache_entry.local_y + dir_offset.y;
+				const int nlz = cache_entry.local_z + dir_offset.z;
+
+				// Shape key of the neighbour cell, or -1 when nothing visible is there
+				int neigh_key = -1;
+				int neigh_layer = -1;
+
+				// Fast bounds check
+				if ((unsigned)nlx < (unsigned)size_x &&
+				    (unsigned)nly < (unsigned)size_y &&
+				    (unsigned)nlz < (unsigned)size_z) {
+					const int n_idx = grid[nlx + nly * stride_y + nlz * stride_z];
+					if (n_idx != -1 && voxel_cache[n_idx].valid) {
+						neigh_key = voxel_cache[n_idx].lookup_key;
+						neigh_layer = in.voxel_props[n_idx].layer;
+					}
+				} else if (in.apron != nullptr) {
+					// Neighbour lies in the adjacent chunk - read its boundary layer
+					neigh_key = in.apron->lookup(face_idx, cache_entry.local_x, cache_entry.local_y, cache_entry.local_z);
+					neigh_layer = in.apron->lookup_layer(face_idx, cache_entry.local_x, cache_entry.local_y, cache_entry.local_z);
+				}
+
+				if (neigh_key != -1) {
+					// Direct access to cached face occupancy - no shape->faces[dir] indirection!
+					const int opp_dir = OPPOSITE_DIR[face_idx];
+					const int neigh_occupancy = face_occupancy_cache[neigh_key * 6 + opp_dir];
+
+					// Direct lookup table access - eliminates function call overhead!
+					const int sub_idx = face.face_occupancy + 1;
+					const int cont_idx = neigh_occupancy + 1;
+					if (occupancy_fits_table[sub_idx * 8 + cont_idx]) {
+						if (!split_layers || neigh_layer == props.layer) {
+							hidden_mask |= 1u << face_idx;
+							continue; // Skip this face
+						}
+						// Only visible while the neighbour's layer is hidden
+						hider_layers[face_idx] = neigh_layer;
+					}
+				}
+			}
+		}
+
+		// Everything this voxel emits with those faces culled, baked by parse_shapes
+		const EmitTemplate &tmpl = emit_templates[cache_entry.lookup_key * 64 + hidden_mask];
+		if (tmpl.tri_count == 0) {
+			continue;
+		}
+		const uint16_t *tmpl_verts = &template_verts[tmpl.vert_start];
+		const TemplateTri *tmpl_tris = &template_tris[tmpl.tri_start];
+
+		// Wobble only the vertices the template references
+		cached_wobbled_local_verts.clear();
+		cached_vertex_colors.clear();
+		const size_t vert_count = tmpl.vert_count;
+		cached_wobbled_local_verts.reserve(vert_count);
+		cached_vertex_colors.reserve(vert_count);
+
+		// Raw noise for every template vertex: wobble[i], [i + n], [i + 2n]
+		std::vector<float> &wobble = scratch.wobble;
+		wobble.resize(vert_count * 3);
+
+		// Vertices still needing noise, with their lattice key (or NO_KEY when uncacheable)
+		std::vector<uint32_t> &miss_verts = scratch.miss_verts;
+		std::vector<uint32_t> &miss_keys = scratch.miss_keys;
+		miss_verts.clear();
+		miss_keys.clear();
+
+		WobbleCache::Block *block = nullptr;
+		size_t block_slot = 0;
+		if (cache_entry.in_chunk && !wobble_blocks.empty()) {
+			const Vector3i b = WobbleCache::block_coord(cache_entry.voxel_pos) - block_min;
+			block_slot = (size_t)(b.x + b.y * blocks_x + b.z * blocks_x * blocks_y);
+			block = wobble_blocks[block_slot].get();
+		}
+		if (block) {
+			std::lock_guard<std::mutex> block_lock(block->mutex);
+			for (size_t i = 0; i < vert_count; i++) {
+				const Vector3 world_pos = shape_data.vertices[tmpl_verts[i]] + v_vec;
+				uint32_t key = NO_KEY;
+				if (WobbleCache::lattice_key(*block, world_pos, key)) {
+					auto hit = block->noise.find(key);
+					if (hit != block->noise.end()) {
+						wobble[i] = hit->second.x;
+						wobble[i + vert_count] = hit->second.y;
+						wobble[i + vert_count * 2] = hit->second.z;
+						continue;
+					}
+				}
+				miss_verts.push_back((uint32_t)i);
+				miss_keys.push_back(key);
+			}
+		} else {
+			for (size_t i = 0; i < vert_count; i++) {
+				miss_verts.push_back((uint32_t)i);
+				miss_keys.push_back(NO_KEY);
+			}
+		}
+
+		const size_t miss_count = miss_verts.size();
+		if (miss_count > 0) {
+			std::vector<float> &world = scratch.world_coords;
+			world.resize(miss_count * 6);
+			float *wx = world.data();
+			float *wy = wx + miss_count;
+			float *wz = wy + miss_count;
+			float *r1 = wz + miss_count;
+			float *r2 = r1 + miss_count;
+			float *r3 = r2 + miss_count;
+			for (size_t m = 0; m < miss_count; m++) {
+				const Vector3 &base_local = shape_data.vertices[tmpl_verts[miss_verts[m]]];
+				wx[m] = base_local.x + v_vec.x;
+				wy[m] = base_local.y + v_vec.y;
+				wz[m] = base_local.z + v_vec.z;
+			}
+
+			if (use_native_noise) {
+				native_noise1.sample_batch(wx, wy, wz, r1, (int)miss_count);
+				native_noise2.sample_batch(wx, wy, wz, r2, (int)miss_count);
+				native_noise3.sample_batch(wx, wy, wz, r3, (int)miss_count);
+			} else {
+				for (size_t m = 0; m < miss_count; m++) {
+					const Vector3 world_pos(wx[m], wy[m], wz[m]);
+					r1[m] = n1->get_noise_3dv(world_pos);
+					r2[m] = n2->get_noise_3dv(world_pos);
+					r3[m] = n3->get_noise_3dv(world_pos);
+				}
+			}
+
+			for (size_t m = 0; m < miss_count; m++) {
+				const uint32_t i = miss_verts[m];
+				wobble[i] = r1[m];
+				wobble[i + vert_count] = r2[m];
+				wobble[i + vert_count * 2] = r3[m];
+			}
+
+			if (block) {
+				size_t inserted = 0;
+				{
+					std::lock_guard<std::mutex> block_lock(block->mutex);
+					for (size_t m = 0; m < miss_count; m++) {
+						if (miss_keys[m] != NO_KEY &&
+								block->noise.emplace(miss_keys[m], Vector3(r1[m], r2[m], r3[m])).second) {
+							inserted++;
+						}
+					}
+					block->entry_count += inserted;
+				}
+				wobble_inserted[block_slot] += inserted;
+			}
+		}
+		wobble_hits += vert_count - miss_count;
+		wobble_misses += miss_count;
+
+		// Wobbled vertices with fast normalization for the colour
+		for (size_t i = 0; i < vert_count; i++) {
+			const Vector3 &base_local = shape_data.vertices[tmpl_verts[i]];
+
+			// Wobbled vertex
+			const Vector3 wobbled_local(
+				base_local.x + wobble[i] * noise_scale,
+				base_local.y + wobble[i + vert_count] * noise_scale,
+				base_local.z + wobble[i + vert_count * 2] * noise_scale
+			);
+			cached_wobbled_local_verts.push_back(wobbled_local);
+
+			// Fast normalized for color calculation using fast inverse sqrt
+			const float len_sq = wobbled_local.length_squared();
+			if (len_sq > norm_threshold) {
+				const float inv_len = fast_inv_sqrt(len_sq);
+				const float nsx = wobbled_local.x * inv_len;
+				const float nsy = wobbled_local.y * inv_len;
+				const float nsz = wobbled_local.z * inv_len;
+				cached_vertex_colors.push_back(Color(
+					(nsx + 1.0f) * half_scale,
+					(nsy + 1.0f) * half_scale,
+					(nsz + 1.0f) * half_scale
+				));
+			} else {
+				cached_vertex_colors.push_back(Color(default_color, default_color, default_color));
+			}
+		}
+
+		if (indexed) {
+			// Fresh weld buckets for this voxel, one chain per template vertex
+			scratch.weld_heads.assign(vert_count, -1);
+			scratch.weld_entries.clear();
+		}
+
+		// Stream the template: per face a UV offset (and face run), then its triangles
+		int current_face = -1;
+		Vector2 uv_offset;
+		Vector3 indexed_face_norm;
+		for (uint32_t t = 0; t < tmpl.tri_count; t++) {
+			const TemplateTri &tri = tmpl_tris[t];
+			const int face_idx = tri.face;
+			if (face_idx != current_face) {
+				current_face = face_idx;
+				const float uv_tile_y = (float)(FACE_UV_COLGROUP_SIZE * props.ty + shape_data.faces[face_idx].tile_voffset);
+				uv_offset = Vector2(
+					du.x * (float)props.tx + dv.x * uv_tile_y,
+					du.y * (float)props.tx + dv.y * uv_tile_y
+				);
+
+				// One run per emitted face: first triangle, then voxel and face packed together
+				if (use_face_runs) {
+					*face_run_cursor++ = triangle_count;
+					*face_run_cursor++ = (voxel_index << FACE_RUN_FACE_BITS) | (int32_t)face_idx;
+				}
+
+				// Wobble moves every corner on its own, so a face's triangles are never
+				// quite coplanar and their flat normals never match. Indexed output gives
+				// the whole face one area-weighted normal so its shared corners weld.
+				if (indexed) {
+					Vector3 sum;
+					for (uint32_t u = t; u < tmpl.tri_count && tmpl_tris[u].face == face_idx; u++) {
+						const Vector3 &c0 = cached_wobbled_local_verts[tmpl_tris[u].corner[0]];
+						const Vector3 &c1 = cached_wobbled_local_verts[tmpl_tris[u].corner[1]];
+						const Vector3 &c2 = cached_wobbled_local_verts[tmpl_tris[u].corner[2]];
+						sum += (c1 - c0).cross(c2 - c0);
+					}
+					const float len_sq = sum.length_squared();
+					indexed_face_norm = len_sq > norm_threshold ? sum * -fast_inv_sqrt(len_sq) : Vector3(0.0f, 0.0f, -1.0f);
+				}
+			}
+
+			// Store triangle info
+			if (use_face_runs) {
+				triangle_count++;
+			} else {
+				out.tri_voxel_info.push_back(voxel_index);
+				out.tri_voxel_info.push_back((int32_t)face_idx);
+			}
+			if (split_layers) {
+				const int hider_layer = face_idx < 6 ? hider_layers[face_idx] : -1;
+				out.tri_groups.push_back(((int32_t)props.layer << 8) | (hider_layer + 1));
+			}
+
+			const int i0 = tri.corner[0];
+			const int i1 = tri.corner[1];
+			const int i2 = tri.corner[2];
+
+			// Get vertices (references to avoid copies)
+			const Vector3 &v0_local = cached_wobbled_local_verts[i0];
+			const Vector3 &v1_local = cached_wobbled_local_verts[i1];
+			const Vector3 &v2_local = cached_wobbled_local_verts[i2];
+
+			// UV coordinates - simple scalar addition
+			Vector2 uv0 = uv_offset;
+			Vector2 uv1 = uv_offset;
+			Vector2 uv2 = uv_offset;
+			if (tri.has_uv_pattern) {
+				uv0 = tri.uv[0] + uv_offset;
+				uv1 = tri.uv[1] + uv_offset;
+				uv2 = tri.uv[2] + uv_offset;
+			}
+
+			if (indexed) {
+				// Corners merge when UV matches too, i.e. within a face; neighbouring
+				// faces keep their own vertices so shading stays flat
+				out.indices.push_back(_weld_vertex(scratch, out, i0, v_vec, indexed_face_norm, uv0));
+				out.indices.push_back(_weld_vertex(scratch, out, i1, v_vec, indexed_face_norm, uv1));
+				out.indices.push_back(_weld_vertex(scratch, out, i2, v_vec, indexed_face_norm, uv2));
+				continue;
+			}
+
+			// Face Normal - simple scalar cross product
+			float cross_x, cross_y, cross_z;
+			cross_product_normalized(
+				v0_local.x, v0_local.y, v0_local.z,
+				v1_local.x, v1_local.y, v1_local.z,
+				v2_local.x, v2_local.y, v2_local.z,
+				cross_x, cross_y, cross_z,
+				norm_threshold
+			);
+			const Vector3 face_norm(cross_x, cross_y, cross_z);
+
+			// Simple scalar addition - SIMD overhead isn't worth it for 3 vectors
+			out.vertices.push_back(v0_local + v_vec);
+			out.vertices.push_back(v1_local + v_vec);
+			out.vertices.push_back(v2_local + v_vec);
+
+			// Vertex colors (already computed)
+			out.normals_smoothed.push_back(cached_vertex_colors[i0]);
+			out.normals_smoothed.push_back(cached_vertex_colors[i1]);
+			out.normals_smoothed.push_back(cached_vertex_colors[i2]);
+
+			out.normals.push_back(face_norm);
+			out.normals.push_back(face_norm);
+			out.normals.push_back(face_norm);
+
+			out.uvs.push_back(uv0);
+			out.uvs.push_back(uv1);
+			out.uvs.push_back(uv2);
+		}
+	}
+
+	if (!wobble_blocks.empty()) {
+		wobble_cache.note_inserted(wobble_blocks, wobble_inserted);
+		// Let blocks evicted meanwhile go now rather than at the next chunk
+		wobble_blocks.clear();
+	}
+	wobble_cache.add_stats(wobble_hits, wobble_misses);
+
+	if (use_face_runs) {
+		// Sentinel: triangles from here on belong to no voxel
+		*face_run_cursor++ = triangle_count;
+		*face_run_cursor++ = -1;
+		out.face_runs.assign(scratch.face_run_buffer.get(), face_run_cursor);
+	}
+}
+
+Dictionary VoxelMesher::_make_mesh_result(const MeshOutput &out) const {
+	Dictionary result;
+	result["arraymesh"] = _build_array_mesh(out, compress_attributes);
+	_store_picking_info(out, result);
+	return result;
+}
+
+void VoxelMesher::_store_picking_info(const MeshOutput &out, Dictionary &r_result) const {
+	// Tri-voxel info to return for raycasting/interaction logic
+	PackedInt32Array tri_voxel_info;
+	tri_voxel_info.resize(out.tri_voxel_info.size());
+	if (!out.tri_voxel_info.empty()) {
+		memcpy(tri_voxel_info.ptrw(), out.tri_voxel_info.data(), out.tri_voxel_info.size() * sizeof(int32_t));
+	}
+
+	if (out.has_face_runs) {
+		PackedInt32Array face_runs;
+		face_runs.resize(out.face_runs.size());
+		if (!out.face_runs.empty()) {
+			memcpy(face_runs.ptrw(), out.face_runs.data(), out.face_runs.size() * sizeof(int32_t));
+		}
+		r_result["face_runs"] = face_runs;
+	} else {
+		r_result["tri_voxel_info"] = tri_voxel_info;
+	}
+}
+
+Dictionary VoxelMesher::_make_surface_data(const MeshOutput &out) {
+	const int64_t vertex_count = (int64_t)out.vertices.size();
+	const bool has_indices = !out.indices.empty();
+
+	// Same layout RenderingServer builds from arrays for an uncompressed
+	// VERTEX | NORMAL | COLOR | TEX_UV surface (format version 2):
+	// vertex buffer = all positions (3 x float), then all normals (octahedral 2 x uint16);
+	// attribute buffer = per vertex colour (RGBA8) followed by UV (2 x float)
+	const int64_t position_stride = sizeof(float) * 3;
+	const int64_t normal_stride = sizeof(uint16_t) * 2;
+	const int64_t attribute_stride = 4 + sizeof(float) * 2;
+
+	PackedByteArray vertex_data;
+	vertex_data.resize(vertex_count * (position_stride + normal_stride));
+	PackedByteArray attribute_data;
+	attribute_data.resize(vertex_count * attribute_stride);
+	uint8_t *positions = vertex_data.ptrw();
+	uint8_t *normals = positions + vertex_count * position_stride;
+	uint8_t *attributes = attribute_data.ptrw();
+
+	Vector3 aabb_min = out.vertices[0];
+	Vector3 aabb_max = out.vertices[0];
+	for (int64_t i = 0; i < vertex_count; i++) {
+		const Vector3 &v = out.vertices[i];
+		const float position[3] = { (float)v.x, (float)v.y, (float)v.z };
+		memcpy(positions + i * position_stride, position, sizeof(position));
+		aabb_min = Vector3(MIN(aabb_min.x, v.x), MIN(aabb_min.y, v.y), MIN(aabb_min.z, v.z));
+		aabb_max = Vector3(MAX(aabb_max.x, v.x), MAX(aabb_max.y, v.y), MAX(aabb_max.z, v.z));
+
+		const Vector2 oct = out.normals[i].octahedron_encode();
+		const uint16_t normal[2] = {
+			(uint16_t)CLAMP(oct.x * 65535, 0, 65535),
+			(uint16_t)CLAMP(oct.y * 65535, 0, 65535)
+		};
+		memcpy(normals + i * normal_stride, normal, sizeof(normal));
+
+		const Color &c = out.normals_smoothed[i];
+		uint8_t *attribute = attributes + i * attribute_stride;
+		attribute[0] = (uint8_t)CLAMP(c.r * 255.0, 0.0, 255.0);
+		attribute[1] = (uint8_t)CLAMP(c.g * 255.0, 0.0, 255.0);
+		attribute[2] = (uint8_t)CLAMP(c.b * 255.0, 0.0, 255.0);
+		attribute[3] = (uint8_t)CLAMP(c.a * 255.0, 0.0, 255.0);
+		const float uv[2] = { (float)out.uvs[i].x, (float)out.uvs[i].y };
+		memcpy(attribute + 4, uv, sizeof(uv));
+	}
+
+	uint64_t format = RenderingServer::ARRAY_FORMAT_VERTEX | RenderingServer::ARRAY_FORMAT_NORMAL |
+			RenderingServer::ARRAY_FORMAT_COLOR | RenderingServer::ARRAY_FORMAT_TEX_UV |
+			RenderingServer::ARRAY_FLAG_FORMAT_CURRENT_VERSION;
+
+	Dictionary surface;
+	surface["primitive"] = RenderingServer::PRIMITIVE_TRIANGLES;
+	surface["vertex_data"] = vertex_data;
+	surface["attribute_data"] = attribute_data;
+	surface["vertex_count"] = vertex_count;
+	surface["aabb"] = AABB(aabb_min, aabb_max - aabb_min);
+
+	if (has_indices) {
+		// 16-bit indices up to and including 65536 vertices - the same test
+		// mesh_create_surface_data_from_arrays uses, and what the renderer
+		// assumes when it reads index_data back
+		format |= RenderingServer::ARRAY_FORMAT_INDEX;
+		const int64_t index_count = (int64_t)out.indices.size();
+		PackedByteArray index_data;
+		if (vertex_count <= (1 << 16)) {
+			index_data.resize(index_count * sizeof(uint16_t));
+			uint16_t *w = (uint16_t *)index_data.ptrw();
+			for (int64_t i = 0; i < index_count; i++) {
+				w[i] = (uint16_t)out.indices[i];
+			}
+		} else {
+			index_data.resize(index_count * sizeof(int32_t));
+			memcpy(index_data.ptrw(), out.indices.data(), index_count * sizeof(int32_t));
+		}
+		surface["index_data"] = index_data;
+		surface["index_count"] = index_count;
+	}
+	surface["format"] = format;
+	return surface;
+}
+
+Ref<ArrayMesh> VoxelMesher::_build_array_mesh(const MeshOutput &out, bool p_compress) const {
+	Ref<ArrayMesh> array_mesh;
+	array_mesh.instantiate();
+
+	// Empty chunks get an empty mesh, like before
+	if (out.vertices.empty()) {
+		return array_mesh;
+	}
+
+	// Compressed surfaces store positions as 16-bit values inside the AABB,
+	// normals octahedral in 2x16 bits and UVs as 16-bit values scaled to their
+	// range; colour is always RGBA8 on the GPU. The engine converts on upload.
+	uint64_t flags = 0;
+	if (p_compress) {
+		flags |= Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES;
+	}
+	array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, _make_surface_arrays(out), TypedArray<Array>(), Dictionary(), flags);
+
+	return array_mesh;
+}
+
+Array VoxelMesher::_make_surface_arrays(const MeshOutput &out) {
+	// Bulk convert to PackedArrays using memcpy for maximum speed
+	PackedVector3Array p_vertices;
+	p_vertices.resize(out.vertices.size());
+	memcpy(p_vertices.ptrw(), out.vertices.data(), out.vertices.size() * sizeof(Vector3));
+
+	PackedVector3Array p_normals;
+	p_normals.resize(out.normals.size());
+	memcpy(p_normals.ptrw(), out.normals.data(), out.normals.size() * sizeof(Vector3));
+
+	PackedColorArray p_colors;
+	p_colors.resize(out.normals_smoothed.size());
+	memcpy(p_colors.ptrw(), out.normals_smoothed.data(), out.normals_smoothed.size() * sizeof(Color));
+
+	PackedVector2Array p_uvs;
+	p_uvs.resize(out.uvs.size());
+	memcpy(p_uvs.ptrw(), out.uvs.data(), out.uvs.size() * sizeof(Vector2));
+
+	Array mesh_arrays;
+	mesh_arrays.resize(Mesh::ARRAY_MAX);
+	mesh_arrays[Mesh::ARRAY_VERTEX] = p_vertices;
+	mesh_arrays[Mesh::ARRAY_NORMAL] = p_normals;
+	mesh_arrays[Mesh::ARRAY_COLOR] = p_colors;
+	mesh_arrays[Mesh::ARRAY_TEX_UV] = p_uvs;
+
+	if (!out.indices.empty()) {
+		PackedInt32Array p_indices;
+		p_indices.resize(out.indices.size());
+		memcpy(p_indices.ptrw(), out.indices.data(), out.indices.size() * sizeof(int32_t));
+		mesh_arrays[Mesh::ARRAY_INDEX] = p_indices;
+	}
+
+	return mesh_arrays;
+}
+
+void VoxelMesher::_build_solid_grid(const ChunkInput &in, std::vector<uint8_t> &r_solid) const {
+	const int sx = in.size_x;
+	const int sy = in.size_y;
+	r_solid.assign(sx * sy * in.size_z, 0);
+
+	// Same visibility rules as the render mesher: visible layer and a known shape
+	for (int i = 0; i < in.voxel_count; i++) {
+		const VoxelData &props = in.voxel_props[i];
+		if ((unsigned)props.layer >= (unsigned)in.layer_count || !in.layers_vis[props.layer]) {
+			continue;
+		}
+		const uint8_t lookup_key = ((uint8_t)props.shape_type) | ((uint8_t)props.rot << 4) | ((props.vflip ? 1 : 0) << 6);
+		if (!shape_lookup_valid[lookup_key]) {
+			continue;
+		}
+		const int lx = in.voxels[i].x - in.chunk_coord.x * sx;
+		const int ly = in.voxels[i].y - in.chunk_coord.y * sy;
+		const int lz = in.voxels[i].z - in.chunk_coord.z * in.size_z;
+		r_solid[lx + ly * sx + lz * sx * sy] = 1;
+	}
+}
 
-		if (lx >= 0 && lx < limit_x && ly >= 0 && ly < limit_y && lz >= 0 && lz < limit_z) {
-			solid_array[lx + ly * stride_y + lz * stride_z] = 1;
+static inline int ctz64(uint64_t x) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return (int)index;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+// Emits the two triangles of one greedy quad, same winding as the original mesher
+static inline void emit_greedy_quad(int axis, int u_axis, int v_axis, int direction,
+		int slice, int u, int v, int width, int height, const Vector3 &offset_vec,
+		std::vector<Vector3> &r_vertices, std::vector<Vector3> *r_normals) {
+	const int pos_on_axis = slice + (direction == 1 ? 1 : 0);
+
+	Vector3 v0;
+	v0[axis] = (float)pos_on_axis;
+	v0[u_axis] = (float)u;
+	v0[v_axis] = (float)v;
+
+	Vector3 v1 = v0;
+	v1[u_axis] += (float)width;
+
+	Vector3 v2 = v0;
+	v2[u_axis] += (float)width;
+	v2[v_axis] += (float)height;
+
+	Vector3 v3 = v0;
+	v3[v_axis] += (float)height;
+
+	const Vector3 p0 = v0 + offset_vec;
+	const Vector3 p1 = v1 + offset_vec;
+	const Vector3 p2 = v2 + offset_vec;
+	const Vector3 p3 = v3 + offset_vec;
+
+	if (direction == 1) {
+		r_vertices.push_back(p0);
+		r_vertices.push_back(p3);
+		r_vertices.push_back(p2);
+
+		r_vertices.push_back(p0);
+		r_vertices.push_back(p2);
+		r_vertices.push_back(p1);
+	} else {
+		r_vertices.push_back(p0);
+		r_vertices.push_back(p1);
+		r_vertices.push_back(p2);
+
+		r_vertices.push_back(p0);
+		r_vertices.push_back(p2);
+		r_vertices.push_back(p3);
+	}
+
+	if (r_normals) {
+		Vector3 normal_vec;
+		normal_vec[axis] = (float)direction;
+		for (int k = 0; k < 6; k++) {
+			r_normals->push_back(normal_vec);
 		}
 	}
+}
 
-	PackedVector3Array vertices;
-	PackedVector3Array normals;
+void VoxelMesher::_greedy_quads(const uint8_t *solid_array, int size_x, int size_y, int size_z,
+		const Vector3 &offset_vec, std::vector<Vector3> &r_vertices, std::vector<Vector3> *r_normals) {
+
+	const int dims[3] = {size_x, size_y, size_z};
+	const int strides[3] = {1, size_x, size_x * size_y};
+
+	// Rows are 64-bit masks along the u axis of each face direction
+	if (size_x > 64 || size_y > 64 || size_z > 64) {
+		_greedy_quads_bytes(solid_array, size_x, size_y, size_z, offset_vec, r_vertices, r_normals);
+		return;
+	}
+
+	std::vector<uint64_t> solid_rows;
+	std::vector<uint64_t> face_rows;
+
+	for (int axis = 0; axis < 3; axis++) {
+		const int u_axis = (axis + 1) % 3;
+		const int v_axis = (axis + 2) % 3;
+
+		const int dim_main = dims[axis];
+		const int dim_u = dims[u_axis];
+		const int dim_v = dims[v_axis];
+
+		// solid_rows[i * dim_v + v] bit u = cell (i, u, v) is solid
+		solid_rows.assign(dim_main * dim_v, 0);
+		for (int i = 0; i < dim_main; i++) {
+			for (int v = 0; v < dim_v; v++) {
+				const uint8_t *cell = solid_array + i * strides[axis] + v * strides[v_axis];
+				const int s_u = strides[u_axis];
+				uint64_t row = 0;
+				for (int u = 0; u < dim_u; u++) {
+					row |= (uint64_t)(cell[u * s_u] == 1) << u;
+				}
+				solid_rows[i * dim_v + v] = row;
+			}
+		}
+
+		face_rows.resize(dim_v);
+
+		const int directions[2] = {-1, 1};
+		for (int d_idx = 0; d_idx < 2; d_idx++) {
+			const int direction = directions[d_idx];
+
+			for (int i = 0; i < dim_main; i++) {
+				// 1. Exposed faces of a whole row at once: solid here and not across the face
+				const bool neighbor_in_bounds = (i + direction >= 0 && i + direction < dim_main);
+				const uint64_t *cur = &solid_rows[i * dim_v];
+				const uint64_t *neigh = neighbor_in_bounds ? &solid_rows[(i + direction) * dim_v] : nullptr;
+				uint64_t any = 0;
+				for (int v = 0; v < dim_v; v++) {
+					face_rows[v] = neigh ? (cur[v] & ~neigh[v]) : cur[v];
+					any |= face_rows[v];
+				}
+				if (!any) {
+					continue;
+				}
+
+				// 2. Greedy merge with bit scans - same quads, in the same order, as the
+				// cell-by-cell version: widest run along u, then grow along v
+				for (int v = 0; v < dim_v; v++) {
+					uint64_t row = face_rows[v];
+					while (row) {
+						const int u = ctz64(row);
+						const uint64_t shifted = row >> u;
+						const int width = (~shifted == 0) ? 64 : ctz64(~shifted);
+						const uint64_t run = (width == 64 ? ~(uint64_t)0 : (((uint64_t)1 << width) - 1)) << u;
+
+						int height = 1;
+						while (v + height < dim_v && (face_rows[v + height] & run) == run) {
+							face_rows[v + height] &= ~run;
+							height++;
+						}
+						row &= ~run;
+
+						emit_greedy_quad(axis, u_axis, v_axis, direction, i, u, v, width, height,
+								offset_vec, r_vertices, r_normals);
+					}
+				}
+			}
+		}
+	}
+}
+
+void VoxelMesher::_greedy_quads_bytes(const uint8_t *solid_array, int size_x, int size_y, int size_z,
+		const Vector3 &offset_vec, std::vector<Vector3> &r_vertices, std::vector<Vector3> *r_normals) {
+
+	int limit_x = size_x;
+	int limit_y = size_y;
+	int limit_z = size_z;
+
+	int stride_x = 1;
+	int stride_y = limit_x;
+	int stride_z = limit_x * limit_y;
+	int strides[3] = {stride_x, stride_y, stride_z};
 
 	int dims[3] = {limit_x, limit_y, limit_z};
 
@@ -798,33 +2416,33 @@ Ref<ArrayMesh> VoxelMesher::generate_simplified_mesh(
 							Vector3 v3 = v0;
 							v3[v_axis] += (float)height;
 
-							Vector3 offset_vec((float)offset.x, (float)offset.y, (float)offset.z);
-
 							Vector3 p0 = v0 + offset_vec;
 							Vector3 p1 = v1 + offset_vec;
 							Vector3 p2 = v2 + offset_vec;
 							Vector3 p3 = v3 + offset_vec;
 
 							if (direction == 1) {
-								vertices.push_back(p0);
-								vertices.push_back(p3);
-								vertices.push_back(p2);
+								r_vertices.push_back(p0);
+								r_vertices.push_back(p3);
+								r_vertices.push_back(p2);
 
-								vertices.push_back(p0);
-								vertices.push_back(p2);
-								vertices.push_back(p1);
+								r_vertices.push_back(p0);
+								r_vertices.push_back(p2);
+								r_vertices.push_back(p1);
 							} else {
-								vertices.push_back(p0);
-								vertices.push_back(p1);
-								vertices.push_back(p2);
+								r_vertices.push_back(p0);
+								r_vertices.push_back(p1);
+								r_vertices.push_back(p2);
 
-								vertices.push_back(p0);
-								vertices.push_back(p2);
-								vertices.push_back(p3);
+								r_vertices.push_back(p0);
+								r_vertices.push_back(p2);
+								r_vertices.push_back(p3);
 							}
 
-							for (int k = 0; k < 6; k++) {
-								normals.push_back(normal_vec);
+							if (r_normals) {
+								for (int k = 0; k < 6; k++) {
+									r_normals->push_back(normal_vec);
+								}
 							}
 
 							// Clear mask
@@ -840,11 +2458,650 @@ Ref<ArrayMesh> VoxelMesher::generate_simplified_mesh(
 			}
 		}
 	}
+}
+
+void VoxelMesher::_greedy_boxes(const uint8_t *solid_array, int size_x, int size_y, int size_z,
+		const Vector3 &offset_vec, std::vector<AABB> &r_boxes) {
+
+	const int stride_y = size_x;
+	const int stride_z = size_x * size_y;
+	std::vector<uint8_t> used(size_x * size_y * size_z, 0);
+
+	for (int z = 0; z < size_z; z++) {
+		for (int y = 0; y < size_y; y++) {
+			for (int x = 0; x < size_x; x++) {
+				const int start = x + y * stride_y + z * stride_z;
+				if (!solid_array[start] || used[start]) {
+					continue;
+				}
+
+				// Grow along x, then whole rows along y, then whole slabs along z
+				int w = 1;
+				while (x + w < size_x && solid_array[start + w] && !used[start + w]) {
+					w++;
+				}
+
+				int h = 1;
+				while (y + h < size_y) {
+					const int row = start + h * stride_y;
+					int k = 0;
+					while (k < w && solid_array[row + k] && !used[row + k]) {
+						k++;
+					}
+					if (k < w) {
+						break;
+					}
+					h++;
+				}
+
+				int d = 1;
+				while (z + d < size_z) {
+					bool full = true;
+					for (int j = 0; j < h && full; j++) {
+						const int row = start + j * stride_y + d * stride_z;
+						for (int k = 0; k < w; k++) {
+							if (!solid_array[row + k] || used[row + k]) {
+								full = false;
+								break;
+							}
+						}
+					}
+					if (!full) {
+						break;
+					}
+					d++;
+				}
+
+				for (int dz = 0; dz < d; dz++) {
+					for (int dy = 0; dy < h; dy++) {
+						memset(&used[start + dy * stride_y + dz * stride_z], 1, w);
+					}
+				}
+
+				r_boxes.push_back(AABB(
+					Vector3((float)x, (float)y, (float)z) + offset_vec,
+					Vector3((float)w, (float)h, (float)d)
+				));
+			}
+		}
+	}
+}
+
+Dictionary VoxelMesher::generate_chunk_mesh_with_collision(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		CollisionMode collision_mode,
+		const Array &neighbours) {
+
+	Dictionary result = generate_chunk_mesh_from_data(chunk_data, layer_visibility, neighbours);
+	if (chunk_data.is_null() || collision_mode == COLLISION_NONE) {
+		return result;
+	}
+
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+	input.layers_vis = layers_vis.data();
+	input.layer_count = (int)layers_vis.size();
+
+	// Every visible voxel counts as a full cube, like generate_simplified_mesh.
+	// Shapes are centred on the voxel position (vertices span +-0.5), so the
+	// cell grid is shifted back half a voxel to line up with the render mesh.
+	std::vector<uint8_t> &solid = main_scratch.solid_grid;
+	_build_solid_grid(input, solid);
+	const Vector3 offset_vec(
+		(float)(input.chunk_coord.x * input.size_x) - 0.5f,
+		(float)(input.chunk_coord.y * input.size_y) - 0.5f,
+		(float)(input.chunk_coord.z * input.size_z) - 0.5f
+	);
+
+	if (collision_mode == COLLISION_FACES) {
+		std::vector<Vector3> &faces = main_scratch.collision_vertices;
+		faces.clear();
+		_greedy_quads(solid.data(), input.size_x, input.size_y, input.size_z, offset_vec, faces, nullptr);
+
+		PackedVector3Array p_faces;
+		p_faces.resize(faces.size());
+		if (!faces.empty()) {
+			memcpy(p_faces.ptrw(), faces.data(), faces.size() * sizeof(Vector3));
+		}
+		Ref<ConcavePolygonShape3D> shape;
+		shape.instantiate();
+		shape->set_faces(p_faces);
+		result["collision_shape"] = shape;
+	} else {
+		std::vector<AABB> boxes;
+		_greedy_boxes(solid.data(), input.size_x, input.size_y, input.size_z, offset_vec, boxes);
+
+		Array p_boxes;
+		p_boxes.resize(boxes.size());
+		for (size_t i = 0; i < boxes.size(); i++) {
+			p_boxes[i] = boxes[i];
+		}
+		result["collision_boxes"] = p_boxes;
+	}
+
+	return result;
+}
+
+static inline int floor_div_int(int a, int b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// Möller-Trumbore, returns the distance along the ray or -1
+static inline float ray_triangle(const Vector3 &origin, const Vector3 &dir,
+		const Vector3 &a, const Vector3 &b, const Vector3 &c) {
+	const Vector3 e1 = b - a;
+	const Vector3 e2 = c - a;
+	const Vector3 p = dir.cross(e2);
+	const float det = e1.dot(p);
+	if (det > -1e-7f && det < 1e-7f) {
+		return -1.0f;
+	}
+	const float inv_det = 1.0f / det;
+	const Vector3 s = origin - a;
+	const float u = s.dot(p) * inv_det;
+	if (u < 0.0f || u > 1.0f) {
+		return -1.0f;
+	}
+	const Vector3 q = s.cross(e1);
+	const float v = dir.dot(q) * inv_det;
+	if (v < 0.0f || u + v > 1.0f) {
+		return -1.0f;
+	}
+	return e2.dot(q) * inv_det;
+}
+
+Dictionary VoxelMesher::raycast_voxels(
+		const Dictionary &chunks,
+		const Vector3 &origin,
+		const Vector3 &direction,
+		float max_distance,
+		int64_t layer_mask,
+		const Vector3i &chunk_size) const {
+
+	Dictionary result;
+	if (chunks.is_empty() || direction.length_squared() < 1e-12f || max_distance <= 0.0f) {
+		return result;
+	}
+	const Vector3 dir = direction.normalized();
+
+	// Chunks in a world share one size. Every chunk the walk reaches is checked
+	// against it before its index grid is read.
+	const int size_x = chunk_size.x > 0 ? chunk_size.x : VoxelChunkData::DEFAULT_SIZE;
+	const int size_y = chunk_size.y > 0 ? chunk_size.y : VoxelChunkData::DEFAULT_SIZE;
+	const int size_z = chunk_size.z > 0 ? chunk_size.z : VoxelChunkData::DEFAULT_SIZE;
+
+	// Voxels are centred on integer positions, so walk a grid shifted by half a cell
+	const Vector3 p(origin.x + 0.5f, origin.y + 0.5f, origin.z + 0.5f);
+	Vector3i cell((int)std::floor(p.x), (int)std::floor(p.y), (int)std::floor(p.z));
+
+	int step[3];
+	float t_max[3];
+	float t_delta[3];
+	for (int axis = 0; axis < 3; axis++) {
+		const float d = dir[axis];
+		if (d > 0.0f) {
+			step[axis] = 1;
+			t_delta[axis] = 1.0f / d;
+			t_max[axis] = ((float)(cell[axis] + 1) - p[axis]) / d;
+		} else if (d < 0.0f) {
+			step[axis] = -1;
+			t_delta[axis] = -1.0f / d;
+			t_max[axis] = ((float)cell[axis] - p[axis]) / d;
+		} else {
+			step[axis] = 0;
+			t_delta[axis] = INFINITY;
+			t_max[axis] = INFINITY;
+		}
+	}
+
+	// Face of the voxel the ray came in through, in DIR_OFFSETS order (-1 = started inside)
+	int entry_face = -1;
+	float t_entry = 0.0f;
+
+	Vector3i current_chunk_coord;
+	const VoxelChunkData *current_chunk = nullptr;
+	bool chunk_looked_up = false;
+
+	const int max_steps = (int)(max_distance * 3.0f) + 4;
+	for (int steps = 0; steps < max_steps && t_entry <= max_distance; steps++) {
+		const Vector3i chunk_coord(
+			floor_div_int(cell.x, size_x),
+			floor_div_int(cell.y, size_y),
+			floor_div_int(cell.z, size_z)
+		);
+		if (!chunk_looked_up || chunk_coord != current_chunk_coord) {
+			current_chunk_coord = chunk_coord;
+			chunk_looked_up = true;
+			current_chunk = nullptr;
+			Ref<VoxelChunkData> chunk = chunks.get(chunk_coord, Variant());
+			// The Dictionary holds the reference for the whole walk
+			if (chunk.is_valid() && chunk->get_chunk_coord() == chunk_coord &&
+					chunk->get_size_x() == size_x && chunk->get_size_y() == size_y && chunk->get_size_z() == size_z) {
+				current_chunk = chunk.ptr();
+			}
+		}
+
+		if (current_chunk != nullptr) {
+			const int lx = cell.x - chunk_coord.x * size_x;
+			const int ly = cell.y - chunk_coord.y * size_y;
+			const int lz = cell.z - chunk_coord.z * size_z;
+			const int32_t index = current_chunk->get_index_grid_ptr()[lx + ly * size_x + lz * size_x * size_y];
+
+			if (index != -1) {
+				const VoxelData &props = current_chunk->get_records_ptr()[index];
+				const uint8_t lookup_key = ((uint8_t)props.shape_type) | ((uint8_t)props.rot << 4) | ((props.vflip ? 1 : 0) << 6);
+
+				if (((layer_mask >> (props.layer & 63)) & 1) && shape_lookup_valid[lookup_key]) {
+					int hit_face = -1;
+					float hit_t = 0.0f;
+
+					if (entry_face != -1 && face_occupancy_cache[lookup_key * 6 + entry_face] == OCCUPANCY_QUAD) {
+						// The shape fills the face we entered through - hit right there
+						hit_face = entry_face;
+						hit_t = t_entry;
+					} else {
+						// Partial shape: test its (unwobbled) triangles
+						const ShapeVariant &shape = *shape_lookup_array[lookup_key];
+						const Vector3 voxel_pos(cell);
+						hit_t = INFINITY;
+						for (size_t face_idx = 0; face_idx < shape.faces.size(); face_idx++) {
+							const std::vector<int> &indices = shape.faces[face_idx].indices;
+							for (size_t k = 0; k + 2 < indices.size(); k += 3) {
+								const float t = ray_triangle(origin, dir,
+									shape.vertices[indices[k]] + voxel_pos,
+									shape.vertices[indices[k + 1]] + voxel_pos,
+									shape.vertices[indices[k + 2]] + voxel_pos);
+								if (t >= 0.0f && t < hit_t) {
+									hit_t = t;
+									hit_face = (int)face_idx;
+								}
+							}
+						}
+					}
+
+					if (hit_face != -1 && hit_t <= max_distance) {
+						result["voxel"] = cell;
+						result["chunk_coord"] = chunk_coord;
+						result["face"] = hit_face;
+						result["normal"] = Vector3(DIR_OFFSETS[hit_face]);
+						result["position"] = origin + dir * hit_t;
+						result["distance"] = hit_t;
+						return result;
+					}
+				}
+			}
+		}
+
+		// Step into the next cell along the axis whose boundary comes first
+		int axis = 0;
+		if (t_max[1] < t_max[axis]) {
+			axis = 1;
+		}
+		if (t_max[2] < t_max[axis]) {
+			axis = 2;
+		}
+		t_entry = t_max[axis];
+		t_max[axis] += t_delta[axis];
+		cell[axis] += step[axis];
+
+		// Moving +x enters through the voxel's -x face, and so on
+		static const int ENTRY_FACE[3][2] = {
+			{ 2, 3 }, // x: stepped -x -> W (+x) face, stepped +x -> E (-x) face
+			{ 4, 5 }, // y: stepped -y -> U face, stepped +y -> D face
+			{ 1, 0 }, // z: stepped -z -> N face, stepped +z -> S face
+		};
+		entry_face = ENTRY_FACE[axis][step[axis] > 0 ? 1 : 0];
+	}
+
+	return result;
+}
+
+// Greedy axis/direction -> face index in DIR_OFFSETS order
+static const int GREEDY_FACE_DIR[3][2] = {
+	{ 3, 2 }, // x: -1 -> E, +1 -> W
+	{ 5, 4 }, // y: -1 -> D, +1 -> U
+	{ 0, 1 }, // z: -1 -> S, +1 -> N
+};
+
+void VoxelMesher::_build_lod_cells(const ChunkInput &in, LodCells &r_cells) const {
+	const int sx = in.size_x;
+	const int sy = in.size_y;
+	const int sz = in.size_z;
+	r_cells.size_x = sx;
+	r_cells.size_y = sy;
+	r_cells.size_z = sz;
+	r_cells.cell_size = 1;
+	r_cells.solid.assign(sx * sy * sz, 0);
+	r_cells.tiles.assign(sx * sy * sz * 6, 0);
+
+	for (int i = 0; i < in.voxel_count; i++) {
+		const VoxelData &props = in.voxel_props[i];
+		if ((unsigned)props.layer >= (unsigned)in.layer_count || !in.layers_vis[props.layer]) {
+			continue;
+		}
+		const uint8_t lookup_key = ((uint8_t)props.shape_type) | ((uint8_t)props.rot << 4) | ((props.vflip ? 1 : 0) << 6);
+		if (!shape_lookup_valid[lookup_key]) {
+			continue;
+		}
+		const int cell = (in.voxels[i].x - in.chunk_coord.x * sx) +
+				(in.voxels[i].y - in.chunk_coord.y * sy) * sx +
+				(in.voxels[i].z - in.chunk_coord.z * sz) * sx * sy;
+		r_cells.solid[cell] = 1;
+
+		// Tile per face direction: the voxel's tile plus that face's row offset
+		const ShapeVariant &shape = *shape_lookup_array[lookup_key];
+		for (int dir = 0; dir < 6; dir++) {
+			const int voffset = dir < (int)shape.faces.size() ? shape.faces[dir].tile_voffset : 0;
+			r_cells.tiles[cell * 6 + dir] = _pack_lod_tile(props.tx, props.ty, voffset);
+		}
+	}
+}
+
+void VoxelMesher::_downsample_lod_cells(const LodCells &p_src, int p_factor, bool p_majority, LodCells &r_dst) {
+	const int sx = (p_src.size_x + p_factor - 1) / p_factor;
+	const int sy = (p_src.size_y + p_factor - 1) / p_factor;
+	const int sz = (p_src.size_z + p_factor - 1) / p_factor;
+	r_dst.size_x = sx;
+	r_dst.size_y = sy;
+	r_dst.size_z = sz;
+	r_dst.cell_size = p_src.cell_size * p_factor;
+	r_dst.solid.assign(sx * sy * sz, 0);
+	r_dst.tiles.assign(sx * sy * sz * 6, 0);
+
+	std::vector<uint32_t> candidates;
+	candidates.reserve(p_factor * p_factor * p_factor);
+
+	for (int z = 0; z < sz; z++) {
+		for (int y = 0; y < sy; y++) {
+			for (int x = 0; x < sx; x++) {
+				int solid_count = 0;
+				int total = 0;
+				for (int dz = 0; dz < p_factor; dz++) {
+					for (int dy = 0; dy < p_factor; dy++) {
+						for (int dx = 0; dx < p_factor; dx++) {
+							const int cx = x * p_factor + dx;
+							const int cy = y * p_factor + dy;
+							const int cz = z * p_factor + dz;
+							if (cx >= p_src.size_x || cy >= p_src.size_y || cz >= p_src.size_z) {
+								continue;
+							}
+							total++;
+							solid_count += p_src.solid[cx + cy * p_src.size_x + cz * p_src.size_x * p_src.size_y];
+						}
+					}
+				}
+
+				// Majority keeps silhouettes honest; any-solid never opens holes
+				const bool solid = p_majority ? (solid_count * 2 >= total && solid_count > 0) : solid_count > 0;
+				if (!solid) {
+					continue;
+				}
+				const int cell = x + y * sx + z * sx * sy;
+				r_dst.solid[cell] = 1;
+
+				// Dominant tile per direction among the solid sub-cells
+				for (int dir = 0; dir < 6; dir++) {
+					candidates.clear();
+					for (int dz = 0; dz < p_factor; dz++) {
+						for (int dy = 0; dy < p_factor; dy++) {
+							for (int dx = 0; dx < p_factor; dx++) {
+								const int cx = x * p_factor + dx;
+								const int cy = y * p_factor + dy;
+								const int cz = z * p_factor + dz;
+								if (cx >= p_src.size_x || cy >= p_src.size_y || cz >= p_src.size_z) {
+									continue;
+								}
+								const int src_cell = cx + cy * p_src.size_x + cz * p_src.size_x * p_src.size_y;
+								if (p_src.solid[src_cell]) {
+									candidates.push_back(p_src.tiles[src_cell * 6 + dir]);
+								}
+							}
+						}
+					}
+					std::sort(candidates.begin(), candidates.end());
+					uint32_t best = 0;
+					size_t best_run = 0;
+					for (size_t k = 0; k < candidates.size();) {
+						size_t run = 1;
+						while (k + run < candidates.size() && candidates[k + run] == candidates[k]) {
+							run++;
+						}
+						if (run > best_run) {
+							best_run = run;
+							best = candidates[k];
+						}
+						k += run;
+					}
+					r_dst.tiles[cell * 6 + dir] = best;
+				}
+			}
+		}
+	}
+}
+
+void VoxelMesher::_greedy_lod_quads(const LodCells &p_cells, const Vector3 &p_offset, MeshOutput &r_out) const {
+	const int dims[3] = {p_cells.size_x, p_cells.size_y, p_cells.size_z};
+	const int strides[3] = {1, p_cells.size_x, p_cells.size_x * p_cells.size_y};
+	const float cell_size = (float)p_cells.cell_size;
+
+	// mask holds tile + 1 for an exposed face, 0 otherwise; only equal tiles merge
+	std::vector<uint32_t> mask;
+
+	for (int axis = 0; axis < 3; axis++) {
+		const int u_axis = (axis + 1) % 3;
+		const int v_axis = (axis + 2) % 3;
+		const int dim_main = dims[axis];
+		const int dim_u = dims[u_axis];
+		const int dim_v = dims[v_axis];
+		mask.assign(dim_u * dim_v, 0);
+
+		for (int d_idx = 0; d_idx < 2; d_idx++) {
+			const int direction = d_idx == 0 ? -1 : 1;
+			const int face_dir = GREEDY_FACE_DIR[axis][d_idx];
+			Vector3 normal_vec;
+			normal_vec[axis] = (float)direction;
+			const Color normal_color((normal_vec.x + 1.0f) * 0.5f, (normal_vec.y + 1.0f) * 0.5f, (normal_vec.z + 1.0f) * 0.5f);
+
+			for (int i = 0; i < dim_main; i++) {
+				const bool neighbor_in_bounds = (i + direction >= 0 && i + direction < dim_main);
+				int n = 0;
+				for (int v = 0; v < dim_v; v++) {
+					for (int u = 0; u < dim_u; u++) {
+						const int idx = i * strides[axis] + u * strides[u_axis] + v * strides[v_axis];
+						const bool exposed = p_cells.solid[idx] &&
+								!(neighbor_in_bounds && p_cells.solid[idx + direction * strides[axis]]);
+						mask[n++] = exposed ? p_cells.tiles[idx * 6 + face_dir] + 1 : 0;
+					}
+				}
+
+				n = 0;
+				for (int v = 0; v < dim_v; v++) {
+					for (int u = 0; u < dim_u; u++, n++) {
+						const uint32_t code = mask[n];
+						if (code == 0) {
+							continue;
+						}
+						int width = 1;
+						while (u + width < dim_u && mask[n + width] == code) {
+							width++;
+						}
+						int height = 1;
+						while (v + height < dim_v) {
+							int w = 0;
+							while (w < width && mask[n + w + height * dim_u] == code) {
+								w++;
+							}
+							if (w < width) {
+								break;
+							}
+							height++;
+						}
+						for (int h = 0; h < height; h++) {
+							for (int w = 0; w < width; w++) {
+								mask[n + w + h * dim_u] = 0;
+							}
+						}
+
+						const size_t first = r_out.vertices.size();
+						emit_greedy_quad(axis, u_axis, v_axis, direction, i, u, v, width, height,
+								Vector3(), r_out.vertices, &r_out.normals);
+						for (size_t k = first; k < r_out.vertices.size(); k++) {
+							r_out.vertices[k] = r_out.vertices[k] * cell_size + p_offset;
+							r_out.normals_smoothed.push_back(normal_color);
+						}
+
+						// Whole quad shows one copy of the dominant tile, stretched
+						const uint32_t tile = code - 1;
+						const int tx = (int)(tile & 0x3FF);
+						const int ty = (int)((tile >> 10) & 0x3FF);
+						const int voffset = (int)(tile >> 20);
+						const float uv_tile_y = (float)(FACE_UV_COLGROUP_SIZE * ty + voffset);
+						const Vector2 uv_offset(
+							du.x * (float)tx + dv.x * uv_tile_y,
+							du.y * (float)tx + dv.y * uv_tile_y
+						);
+						// Corner order follows emit_greedy_quad: p0 p3 p2 p0 p2 p1 (+) or p0 p1 p2 p0 p2 p3 (-)
+						const Vector2 uv_p0 = uv_offset + dv;
+						const Vector2 uv_p1 = uv_offset + du + dv;
+						const Vector2 uv_p2 = uv_offset + du;
+						const Vector2 uv_p3 = uv_offset;
+						if (direction == 1) {
+							r_out.uvs.push_back(uv_p0);
+							r_out.uvs.push_back(uv_p3);
+							r_out.uvs.push_back(uv_p2);
+							r_out.uvs.push_back(uv_p0);
+							r_out.uvs.push_back(uv_p2);
+							r_out.uvs.push_back(uv_p1);
+						} else {
+							r_out.uvs.push_back(uv_p0);
+							r_out.uvs.push_back(uv_p1);
+							r_out.uvs.push_back(uv_p2);
+							r_out.uvs.push_back(uv_p0);
+							r_out.uvs.push_back(uv_p2);
+							r_out.uvs.push_back(uv_p3);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TypedArray<Dictionary> VoxelMesher::generate_chunk_lod_chain(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const Array &neighbours) {
+
+	TypedArray<Dictionary> levels;
+	if (chunk_data.is_null()) {
+		ERR_PRINT("generate_chunk_lod_chain: chunk_data is null");
+		return levels;
+	}
+
+	// LOD 0: the full wobbled mesh
+	Dictionary full = generate_chunk_mesh_from_data(chunk_data, layer_visibility, neighbours);
+	full["cell_size"] = 1;
+	levels.push_back(full);
+
+	ChunkInput input;
+	_fill_chunk_input(*chunk_data.ptr(), input);
+	std::vector<uint8_t> layers_vis;
+	_unpack_layer_visibility(layer_visibility, layers_vis);
+	input.layers_vis = layers_vis.data();
+	input.layer_count = (int)layers_vis.size();
+
+	// Cells are centred on voxel positions, like the native collision
+	const Vector3 offset_vec(
+		(float)(input.chunk_coord.x * input.size_x) - 0.5f,
+		(float)(input.chunk_coord.y * input.size_y) - 0.5f,
+		(float)(input.chunk_coord.z * input.size_z) - 0.5f
+	);
+
+	// LOD 1: greedy at full resolution, LOD 2: 2x majority, LOD 3: 4x any-solid
+	LodCells full_cells;
+	LodCells half_cells;
+	LodCells quarter_cells;
+	_build_lod_cells(input, full_cells);
+	_downsample_lod_cells(full_cells, 2, true, half_cells);
+	_downsample_lod_cells(full_cells, 4, false, quarter_cells);
+
+	const LodCells *cell_levels[3] = { &full_cells, &half_cells, &quarter_cells };
+	MeshOutput lod_output;
+	for (int level = 0; level < 3; level++) {
+		lod_output.vertices.clear();
+		lod_output.normals.clear();
+		lod_output.normals_smoothed.clear();
+		lod_output.uvs.clear();
+		_greedy_lod_quads(*cell_levels[level], offset_vec, lod_output);
+
+		Dictionary lod = _make_mesh_result(lod_output);
+		lod.erase("tri_voxel_info");
+		lod.erase("face_runs");
+		lod["cell_size"] = cell_levels[level]->cell_size;
+		levels.push_back(lod);
+	}
+
+	return levels;
+}
+
+int VoxelMesher::select_lod_level(float distance, const PackedFloat32Array &lod_distances) {
+	// lod_distances[i] is where level i stops being used
+	for (int i = 0; i < lod_distances.size(); i++) {
+		if (distance < lod_distances[i]) {
+			return i;
+		}
+	}
+	return (int)lod_distances.size();
+}
+
+Ref<ArrayMesh> VoxelMesher::generate_simplified_mesh(
+		const Vector3i &chunk_coord,
+		const Array &voxels,
+		int size_x, int size_y, int size_z) {
+
+	int limit_x = size_x;
+	int limit_y = size_y;
+	int limit_z = size_z;
+
+	std::vector<uint8_t> solid_array(limit_x * limit_y * limit_z, 0);
+
+	Vector3i offset(chunk_coord.x * size_x, chunk_coord.y * size_y, chunk_coord.z * size_z);
+
+	int stride_y = limit_x;
+	int stride_z = limit_x * limit_y;
+
+	int voxel_count = voxels.size();
+	for (int i = 0; i < voxel_count; i++) {
+		Vector3i v = voxels[i];
+		int lx = v.x - offset.x;
+		int ly = v.y - offset.y;
+		int lz = v.z - offset.z;
+
+		if (lx >= 0 && lx < limit_x && ly >= 0 && ly < limit_y && lz >= 0 && lz < limit_z) {
+			solid_array[lx + ly * stride_y + lz * stride_z] = 1;
+		}
+	}
 
-	if (vertices.size() == 0) {
+	std::vector<Vector3> quad_vertices;
+	std::vector<Vector3> quad_normals;
+	const Vector3 offset_vec((float)offset.x, (float)offset.y, (float)offset.z);
+	_greedy_quads(solid_array.data(), limit_x, limit_y, limit_z, offset_vec, quad_vertices, &quad_normals);
+
+	if (quad_vertices.empty()) {
 		return Ref<ArrayMesh>();
 	}
 
+	PackedVector3Array vertices;
+	vertices.resize(quad_vertices.size());
+	memcpy(vertices.ptrw(), quad_vertices.data(), quad_vertices.size() * sizeof(Vector3));
+
+	PackedVector3Array normals;
+	normals.resize(quad_normals.size());
+	memcpy(normals.ptrw(), quad_normals.data(), quad_normals.size() * sizeof(Vector3));
+
 	Ref<ArrayMesh> mesh;
 	mesh.instantiate();
 
@@ -861,7 +3118,41 @@ Ref<ArrayMesh> VoxelMesher::generate_simplified_mesh(
 void VoxelMesher::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("initialize_noise", "seed"), &VoxelMesher::initialize_noise);
 	ClassDB::bind_method(D_METHOD("set_texture_dimensions", "width", "height"), &VoxelMesher::set_texture_dimensions);
+	ClassDB::bind_method(D_METHOD("set_indexed_output", "enabled"), &VoxelMesher::set_indexed_output);
+	ClassDB::bind_method(D_METHOD("get_indexed_output"), &VoxelMesher::get_indexed_output);
+	ClassDB::bind_method(D_METHOD("set_face_runs_output", "enabled"), &VoxelMesher::set_face_runs_output);
+	ClassDB::bind_method(D_METHOD("get_face_runs_output"), &VoxelMesher::get_face_runs_output);
+	ClassDB::bind_static_method("VoxelMesher", D_METHOD("triangle_to_voxel_face", "face_runs", "tri_index"), &VoxelMesher::triangle_to_voxel_face);
+	ClassDB::bind_method(D_METHOD("set_compress_attributes", "enabled"), &VoxelMesher::set_compress_attributes);
+	ClassDB::bind_method(D_METHOD("get_compress_attributes"), &VoxelMesher::get_compress_attributes);
+	ClassDB::bind_method(D_METHOD("set_native_noise", "enabled"), &VoxelMesher::set_native_noise);
+	ClassDB::bind_method(D_METHOD("get_native_noise"), &VoxelMesher::get_native_noise);
+	ClassDB::bind_method(D_METHOD("get_native_noise_simd_level"), &VoxelMesher::get_native_noise_simd_level);
+	ClassDB::bind_method(D_METHOD("set_wobble_cache_limit_mb", "megabytes"), &VoxelMesher::set_wobble_cache_limit_mb);
+	ClassDB::bind_method(D_METHOD("get_wobble_cache_limit_mb"), &VoxelMesher::get_wobble_cache_limit_mb);
+	ClassDB::bind_method(D_METHOD("clear_wobble_cache"), &VoxelMesher::clear_wobble_cache);
+	ClassDB::bind_method(D_METHOD("get_wobble_cache_stats"), &VoxelMesher::get_wobble_cache_stats);
+	ClassDB::bind_method(D_METHOD("generate_chunk_layered_mesh", "chunk_data", "layer_count", "neighbours"), &VoxelMesher::generate_chunk_layered_mesh, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("compose_layer_mesh", "layered", "layer_visibility"), &VoxelMesher::compose_layer_mesh);
+	ClassDB::bind_method(D_METHOD("generate_patchable_chunk_mesh", "chunk_data", "layer_visibility", "neighbours"), &VoxelMesher::generate_patchable_chunk_mesh, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("patch_chunk_mesh", "chunk_data", "edited_voxels", "neighbours"), &VoxelMesher::patch_chunk_mesh, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("release_patchable_chunk", "chunk_coord"), &VoxelMesher::release_patchable_chunk);
+	ClassDB::bind_method(D_METHOD("generate_chunk_mesh_to_rid", "chunk_data", "layer_visibility", "mesh_rid", "neighbours"), &VoxelMesher::generate_chunk_mesh_to_rid, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("set_mesh_cache_limit_mb", "megabytes"), &VoxelMesher::set_mesh_cache_limit_mb);
+	ClassDB::bind_method(D_METHOD("get_mesh_cache_limit_mb"), &VoxelMesher::get_mesh_cache_limit_mb);
+	ClassDB::bind_method(D_METHOD("clear_mesh_cache"), &VoxelMesher::clear_mesh_cache);
+	ClassDB::bind_method(D_METHOD("get_mesh_cache_stats"), &VoxelMesher::get_mesh_cache_stats);
 	ClassDB::bind_method(D_METHOD("parse_shapes", "gd_database", "gd_uv_patterns"), &VoxelMesher::parse_shapes);
 	ClassDB::bind_method(D_METHOD("generate_chunk_mesh", "chunk_coord", "voxels", "voxel_properties", "layer_visibility", "size_x", "size_y", "size_z"), &VoxelMesher::generate_chunk_mesh);
+	ClassDB::bind_method(D_METHOD("generate_chunk_mesh_from_data", "chunk_data", "layer_visibility", "neighbours"), &VoxelMesher::generate_chunk_mesh_from_data, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("generate_chunk_mesh_with_collision", "chunk_data", "layer_visibility", "collision_mode", "neighbours"), &VoxelMesher::generate_chunk_mesh_with_collision, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("raycast_voxels", "chunks", "origin", "direction", "max_distance", "layer_mask", "chunk_size"), &VoxelMesher::raycast_voxels, DEFVAL(-1), DEFVAL(Vector3i(VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE)));
+	ClassDB::bind_method(D_METHOD("generate_chunk_lod_chain", "chunk_data", "layer_visibility", "neighbours"), &VoxelMesher::generate_chunk_lod_chain, DEFVAL(Array()));
+	ClassDB::bind_static_method("VoxelMesher", D_METHOD("select_lod_level", "distance", "lod_distances"), &VoxelMesher::select_lod_level);
+	ClassDB::bind_method(D_METHOD("generate_chunk_meshes_batch", "chunks", "layer_visibility", "cull_chunk_borders"), &VoxelMesher::generate_chunk_meshes_batch, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("generate_simplified_mesh", "chunk_coord", "voxels", "size_x", "size_y", "size_z"), &VoxelMesher::generate_simplified_mesh);
+
+	BIND_ENUM_CONSTANT(COLLISION_NONE);
+	BIND_ENUM_CONSTANT(COLLISION_FACES);
+	BIND_ENUM_CONSTANT(COLLISION_BOXES);
 }
@@ -4,20 +4,42 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/classes/fast_noise_lite.hpp>
 #include <godot_cpp/variant/vector3i.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
 #include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
 #include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/concave_polygon_shape3d.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include "voxel_chunk_data.h"
+#include "value_noise.h"
+#include "wobble_cache.h"
+#include "mesh_result_cache.h"
 #include <vector>
 #include <map>
 #include <unordered_map>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 namespace godot {
 
 class VoxelMesher : public RefCounted {
 	GDCLASS(VoxelMesher, RefCounted)
 
+public:
+	enum CollisionMode {
+		COLLISION_NONE,
+		COLLISION_FACES, // "collision_shape": ConcavePolygonShape3D from the greedy quads
+		COLLISION_BOXES, // "collision_boxes": Array of world-space AABBs for a compound body
+	};
+
+	// The remesh queue drives _mesh_chunk() from its own worker threads
+	friend class VoxelRemeshQueue;
+
 private:
 	struct FaceData {
 		std::vector<int> indices;
@@ -33,6 +55,11 @@ private:
 		// Pre-calculated wobbled vertices could be cached per voxel, not per shape
 	};
 
+	// Face runs keep the face index in the low bits of each entry, so
+	// parse_shapes skips shapes with more faces than those bits can hold
+	static const int FACE_RUN_FACE_BITS = 3;
+	static const int MAX_SHAPE_FACES = 1 << FACE_RUN_FACE_BITS;
+
 	// Flattened array: key = shape_type | (rotation << 4) | (vflip << 6)
 	// Encodes all combinations in a single byte: shape_type (0-12, 4 bits), rotation (0-3, 2 bits), vflip (0-1, 1 bit)
 	// 256 possible combinations - direct array access with zero hash overhead!
@@ -65,41 +92,231 @@ private:
 	FastNoiseLite *cached_noise1;
 	FastNoiseLite *cached_noise2;
 	FastNoiseLite *cached_noise3;
+
+	// In-process value noise matching noise1..3, sampled a whole shape at a time.
+	// native_noise = false goes back to the FastNoiseLite calls.
+	ValueNoise native_noise1;
+	ValueNoise native_noise2;
+	ValueNoise native_noise3;
+	bool native_noise;
+
+	// Raw noise per world-space lattice point, shared by every chunk and thread.
+	// mutable: filling it is not an observable change to the mesher.
+	mutable WobbleCache wobble_cache;
 	
-	// Reusable buffers - pre-allocated and cleared between calls to avoid allocations
-	// Since size_x/y/z are constant, we can reuse these across all 190 calls
-	std::vector<Vector3> final_vertices;
-	std::vector<Vector3> final_normals;
-	std::vector<Color> final_normals_smoothed;
-	std::vector<Vector2> final_uvs;
-	
-	struct VoxelData {
-		int16_t shape_type;
-		int16_t tx, ty;
-		int8_t rot;
-		bool vflip;
-		int8_t layer;
-	} __attribute__((packed));
-	
+	// What a voxel of one shape variant emits when the side faces set in a
+	// 6-bit hidden mask are culled, baked by parse_shapes for every
+	// (shape key, mask). Corners index the template's own vertex list, so only
+	// vertices some emitted triangle uses get wobbled.
+	struct EmitTemplate {
+		uint32_t vert_start = 0; // into template_verts
+		uint32_t vert_count = 0;
+		uint32_t tri_start = 0; // into template_tris
+		uint32_t tri_count = 0;
+	};
+
+	struct TemplateTri {
+		uint16_t corner[3]; // into the template's vertex list
+		uint8_t face; // face index, triangles of a face are contiguous
+		bool has_uv_pattern;
+		Vector2 uv[3]; // UV pattern values, before the per-voxel tile offset
+	};
+
+	std::vector<EmitTemplate> emit_templates; // [key * 64 + hidden_mask]
+	std::vector<uint16_t> template_verts; // shape vertex index per template vertex
+	std::vector<TemplateTri> template_tris;
+	uint32_t max_template_faces = 0; // most faces any one template emits
+
 	struct CachedVoxelInfo {
 		const ShapeVariant *shape_ptr;
 		uint8_t lookup_key;
 		Vector3i voxel_pos;
 		int local_x, local_y, local_z;
 		bool valid;
+		// Inside [0, size) on every axis. Array callers may pass voxels outside the
+		// chunk; those are still meshed but never touch the face-bits rows.
+		bool in_chunk;
 	};
-	
-	std::vector<VoxelData> unpacked_props;
-	std::vector<Vector3i> unpacked_voxels;
-	std::vector<bool> layers_vis;
-	std::vector<int> grid_cache;
-	std::vector<CachedVoxelInfo> voxel_cache;
-	std::vector<Vector3> cached_wobbled_local_verts;
-	std::vector<Color> cached_vertex_colors;
-	
-	// Track current chunk dimensions to resize grid_cache only when needed
-	int cached_size_x, cached_size_y, cached_size_z;
-	
+
+	// One welded output vertex, chained per shape vertex index (indexed output)
+	struct WeldEntry {
+		int32_t next;
+		int32_t out_index;
+		Vector3 normal;
+		Vector2 uv;
+	};
+
+	// Per-thread scratch arena - everything the mesher writes while meshing one chunk.
+	// Buffers are cleared between calls but keep their capacity.
+	struct MeshScratch {
+		std::vector<VoxelData> unpacked_props;
+		std::vector<Vector3i> unpacked_voxels;
+		std::vector<int32_t> grid_cache;
+		std::vector<CachedVoxelInfo> voxel_cache;
+		std::vector<Vector3> cached_wobbled_local_verts;
+		std::vector<Color> cached_vertex_colors;
+		std::vector<float> world_coords; // x[], y[], z[] and noise results of the cache misses
+		std::vector<float> wobble; // noise1[], noise2[], noise3[] for the shape's vertices
+		std::vector<uint32_t> miss_verts;
+		std::vector<uint32_t> miss_keys;
+		std::vector<WobbleCache::BlockRef> wobble_blocks; // blocks under the chunk being meshed
+		std::vector<size_t> wobble_inserted; // entries added per wobble_blocks slot
+		std::vector<uint8_t> solid_grid;
+		std::vector<uint64_t> face_bits; // face visibility pre-pass rows
+		std::vector<Vector3> collision_vertices;
+		std::vector<int32_t> weld_heads;
+		std::vector<WeldEntry> weld_entries;
+		// Face runs are written here by cursor, then copied out at their real length.
+		// Sized for the worst case without being cleared (new[] leaves it uninitialised).
+		std::unique_ptr<int32_t[]> face_run_buffer;
+		size_t face_run_capacity = 0;
+
+		// Track current chunk dimensions to resize grid_cache only when needed
+		int cached_size_x = -1, cached_size_y = -1, cached_size_z = -1;
+	};
+
+	// Boundary layers of the six neighbouring chunks, in DIR_OFFSETS order.
+	// Each cell holds the neighbour voxel's shape key | layer << 8, or -1 for empty/hidden.
+	// An empty vector means that side is open (no neighbour chunk).
+	struct ChunkApron {
+		std::vector<int16_t> faces[6];
+		int size_x = 0, size_y = 0, size_z = 0;
+
+		// Key across face dir of the voxel at local (lx, ly, lz) on our boundary
+		inline int lookup(int dir, int lx, int ly, int lz) const {
+			const int cell = _cell(dir, lx, ly, lz);
+			return cell < 0 ? -1 : (cell & 0xFF);
+		}
+
+		// Layer of that voxel, -1 when there is none
+		inline int lookup_layer(int dir, int lx, int ly, int lz) const {
+			const int cell = _cell(dir, lx, ly, lz);
+			return cell < 0 ? -1 : (cell >> 8);
+		}
+
+		inline int _cell(int dir, int lx, int ly, int lz) const {
+			const std::vector<int16_t> &layer = faces[dir];
+			if (layer.empty()) {
+				return -1;
+			}
+			int a, b, dim_a, dim_b;
+			if (dir < 2) { // S, N
+				a = lx; b = ly; dim_a = size_x; dim_b = size_y;
+			} else if (dir < 4) { // W, E
+				a = ly; b = lz; dim_a = size_y; dim_b = size_z;
+			} else { // U, D
+				a = lx; b = lz; dim_a = size_x; dim_b = size_z;
+			}
+			if ((unsigned)a >= (unsigned)dim_a || (unsigned)b >= (unsigned)dim_b) {
+				return -1;
+			}
+			return layer[a + b * dim_a];
+		}
+	};
+
+	// Read-only view of one chunk's voxels; built on the calling thread
+	struct ChunkInput {
+		Vector3i chunk_coord;
+		const Vector3i *voxels = nullptr;
+		const VoxelData *voxel_props = nullptr;
+		int voxel_count = 0;
+		const int32_t *voxel_grid = nullptr; // optional prebuilt index grid
+		const uint8_t *layers_vis = nullptr;
+		int layer_count = 0;
+		int size_x = 0, size_y = 0, size_z = 0;
+		const ChunkApron *apron = nullptr; // optional, culls faces across chunk borders
+		// Keep faces hidden by a voxel on another layer, tagged in MeshOutput::tri_groups
+		// (generate_chunk_layered_mesh). Implies flat_output.
+		bool split_layers = false;
+		// Three vertices per triangle and tri_voxel_info, whatever the output options say
+		bool flat_output = false;
+		// Only emit these voxels (in this order) instead of the whole chunk.
+		// Skips the face-bits pre-pass, which costs a pass over every row.
+		const int32_t *voxel_subset = nullptr;
+		int voxel_subset_count = 0;
+	};
+
+	// Raw mesher output, turned into an ArrayMesh on the calling thread
+	struct MeshOutput {
+		std::vector<Vector3> vertices;
+		std::vector<Vector3> normals;
+		std::vector<Color> normals_smoothed;
+		std::vector<Vector2> uvs;
+		std::vector<int32_t> tri_voxel_info;
+		std::vector<int32_t> indices; // only filled in indexed output mode
+		// (start_tri, voxel << FACE_RUN_FACE_BITS | face) pairs, replaces tri_voxel_info. Ends with a
+		// (triangle_count, -1) sentinel run when the chunk has voxels.
+		std::vector<int32_t> face_runs;
+		std::vector<int32_t> tri_groups; // split_layers only: layer << 8 | (hiding layer + 1) per triangle
+		// Recorded by _mesh_chunk, so results finished on another thread are read
+		// with the options they were meshed with
+		bool has_face_runs = false;
+		uint64_t config_generation = 0;
+	};
+
+	struct BatchJob {
+		std::vector<ChunkInput> inputs;
+		std::vector<MeshOutput> outputs;
+	};
+
+	// Scratch and output used by the single-chunk entry points (main thread)
+	MeshScratch main_scratch;
+	MeshOutput main_output;
+
+	// Scratch arenas handed out to worker threads
+	std::vector<std::unique_ptr<MeshScratch>> scratch_pool;
+	std::mutex scratch_pool_mutex;
+	BatchJob *active_batch;
+
+	// Emit ARRAY_INDEX and weld each face's shared corners instead of 3 vertices per
+	// triangle. Every triangle of a face gets the face's averaged normal, so a quad
+	// takes 4 vertices instead of 6.
+	bool indexed_output;
+
+	// Emit "face_runs" (one pair per face) instead of "tri_voxel_info" (one pair per triangle)
+	bool face_runs_output;
+
+	// Build chunk surfaces with ARRAY_FLAG_COMPRESS_ATTRIBUTES (false = full precision)
+	bool compress_attributes;
+
+	// Finished results of generate_chunk_mesh*, keyed by _hash_chunk_input().
+	// mesh_config_generation goes into every key and is bumped (clearing the
+	// cache) whenever shapes, texture size, seeds or output options change.
+	MeshResultCache mesh_cache;
+	uint64_t mesh_config_generation;
+
+	// Held shared by _mesh_chunk and exclusively by every setter that changes what
+	// it reads (shapes, emit templates, texture size, seeds, output options), so
+	// remesh queue workers never see the config half rewritten
+	mutable std::shared_mutex config_mutex;
+
+	// Incremental remeshing (generate_patchable_chunk_mesh / patch_chunk_mesh).
+	// Every voxel owns a contiguous vertex range ("slot") of one uncompressed
+	// surface; an edit re-emits the touched voxels into their slots, padding with
+	// degenerate triangles, and uploads just those ranges. Voxels that outgrow
+	// their slot move into spare space at the end of the surface.
+	struct PatchSlot {
+		int32_t first_vertex = -1; // -1 = nothing allocated for this cell yet
+		int32_t capacity = 0; // vertices, a multiple of 3
+		int32_t voxel_index = -1; // chunk index the triangles were emitted for
+	};
+
+	struct PatchState {
+		Ref<ArrayMesh> mesh;
+		uint64_t format = 0;
+		int32_t vertex_capacity = 0; // vertices in the GPU surface
+		int32_t tail = 0; // first vertex of the unused spare space
+		int32_t abandoned = 0; // vertices left behind by slots that moved
+		Vector3i size;
+		std::vector<PatchSlot> slots; // per local cell
+		std::vector<int32_t> tri_voxel_info; // (-1, -1) for padding triangles
+		std::vector<uint8_t> layers_vis;
+		uint64_t config_generation = 0; // mesh_config_generation at build time
+	};
+
+	std::map<Vector3i, PatchState> patch_states;
+	MeshOutput patch_output; // one slot's worth of vertices on its way to the GPU
+
 	// Constants
 	const float TILE_W = 16.0f;
 	const float TILE_H = 16.0f;
@@ -115,6 +332,63 @@ private:
 	void _cache_wobbled_verts(const Vector3i &voxel, const ShapeVariant &shape, 
 		const Vector3i &offset, std::vector<Vector3> &out_verts, std::vector<Color> &out_colors);
 
+	// Shared mesher core. Only reads the shape database, so it is safe to run
+	// on several threads at once as long as each has its own scratch/output.
+	// Takes config_mutex shared; never call it with the lock already held.
+	void _mesh_chunk(const ChunkInput &in, MeshScratch &scratch, MeshOutput &out) const;
+	Dictionary _make_mesh_result(const MeshOutput &out) const;
+	Ref<ArrayMesh> _build_array_mesh(const MeshOutput &out, bool p_compress) const;
+	static Array _make_surface_arrays(const MeshOutput &out);
+	static Dictionary _make_surface_data(const MeshOutput &out);
+	void _store_picking_info(const MeshOutput &out, Dictionary &r_result) const;
+	void _build_patchable(const VoxelChunkData &p_chunk, const ChunkApron *p_apron, PatchState &r_state);
+	void _build_emit_templates();
+	// False when the chunk has to be rebuilt instead (size change, out of spare space)
+	bool _patch_voxels(ChunkInput &p_input, const std::vector<Vector3i> &p_edited, PatchState &r_state);
+	bool _upload_patch(PatchState &r_state, int32_t p_first_vertex, int32_t p_capacity, const MeshOutput &p_src, int32_t p_src_first, int32_t p_count, const Vector3 &p_pad_pos);
+	static Dictionary _patch_result(const PatchState &p_state, bool p_rebuilt);
+	uint64_t _hash_chunk_input(const ChunkInput &in) const;
+	Dictionary _mesh_chunk_cached(const ChunkInput &in, MeshScratch &scratch);
+	void _bump_mesh_config();
+
+	static int32_t _weld_vertex(MeshScratch &scratch, MeshOutput &out, int vertex_index,
+		const Vector3 &voxel_pos, const Vector3 &normal, const Vector2 &uv);
+
+	MeshScratch *_acquire_scratch();
+	void _release_scratch(MeshScratch *p_scratch);
+	void _batch_mesh_element(uint32_t p_index);
+
+	void _build_apron(const ChunkInput &p_input, const VoxelChunkData *const p_neighbours[6], ChunkApron &r_apron) const;
+	// Same, from a script Array of up to 6 VoxelChunkData in DIR_OFFSETS order (nulls are open)
+	void _build_apron_from_array(const Array &p_neighbours, const ChunkInput &p_input, ChunkApron &r_apron) const;
+	static void _fill_chunk_input(const VoxelChunkData &p_data, ChunkInput &r_input);
+	static void _unpack_layer_visibility(const Array &p_layer_visibility, std::vector<uint8_t> &r_layers_vis);
+
+	// Solid cells plus one packed tile per face direction, at some cell size (LOD chain)
+	struct LodCells {
+		int size_x = 0, size_y = 0, size_z = 0;
+		int cell_size = 1; // voxels per cell side
+		std::vector<uint8_t> solid;
+		std::vector<uint32_t> tiles; // [cell * 6 + dir], see _pack_lod_tile
+	};
+
+	static inline uint32_t _pack_lod_tile(int tx, int ty, int voffset) {
+		return ((uint32_t)tx & 0x3FF) | (((uint32_t)ty & 0x3FF) << 10) | (((uint32_t)voffset & 0x3FF) << 20);
+	}
+	void _build_lod_cells(const ChunkInput &in, LodCells &r_cells) const;
+	static void _downsample_lod_cells(const LodCells &p_src, int p_factor, bool p_majority, LodCells &r_dst);
+	void _greedy_lod_quads(const LodCells &p_cells, const Vector3 &p_offset, MeshOutput &r_out) const;
+
+	// Solid-cell passes shared by collision and the simplified mesh
+	void _build_solid_grid(const ChunkInput &in, std::vector<uint8_t> &r_solid) const;
+	static void _greedy_quads(const uint8_t *solid_array, int size_x, int size_y, int size_z,
+		const Vector3 &offset_vec, std::vector<Vector3> &r_vertices, std::vector<Vector3> *r_normals);
+	// Cell-by-cell version, only used for chunks wider than 64 on some axis
+	static void _greedy_quads_bytes(const uint8_t *solid_array, int size_x, int size_y, int size_z,
+		const Vector3 &offset_vec, std::vector<Vector3> &r_vertices, std::vector<Vector3> *r_normals);
+	static void _greedy_boxes(const uint8_t *solid_array, int size_x, int size_y, int size_z,
+		const Vector3 &offset_vec, std::vector<AABB> &r_boxes);
+
 protected:
 	static void _bind_methods();
 
@@ -122,6 +396,32 @@ public:
 	VoxelMesher();
 	~VoxelMesher();
 
+	void set_indexed_output(bool p_enabled);
+	bool get_indexed_output() const;
+	void set_face_runs_output(bool p_enabled);
+	bool get_face_runs_output() const;
+
+	// Voxel index (x) and face (y) of a triangle, by binary search over "face_runs".
+	// (-1, -1) for a negative tri_index, one at or past the triangle count (the
+	// trailing sentinel run) or an empty table.
+	static Vector2i triangle_to_voxel_face(const PackedInt32Array &face_runs, int tri_index);
+	void set_compress_attributes(bool p_enabled);
+	bool get_compress_attributes() const;
+	void set_native_noise(bool p_enabled);
+	bool get_native_noise() const;
+	String get_native_noise_simd_level() const;
+	void set_wobble_cache_limit_mb(int p_megabytes);
+	int get_wobble_cache_limit_mb() const;
+	void clear_wobble_cache();
+	Dictionary get_wobble_cache_stats();
+
+	// Result cache for generate_chunk_mesh / generate_chunk_mesh_from_data.
+	// Each hit returns a new Dictionary, but the ArrayMesh is shared, so do not modify it.
+	void set_mesh_cache_limit_mb(int p_megabytes);
+	int get_mesh_cache_limit_mb() const;
+	void clear_mesh_cache();
+	Dictionary get_mesh_cache_stats() const;
+
 	void initialize_noise(int seed);
 	void set_texture_dimensions(float width, float height);
 	void parse_shapes(const Array &gd_database, const Dictionary &gd_uv_patterns);
@@ -135,6 +435,117 @@ public:
 		int size_x, int size_y, int size_z
 	);
 
+	// Same output as generate_chunk_mesh, reading straight from native chunk storage.
+	// neighbours: optional 6 VoxelChunkData (S, N, W, E, U, D, null = none) whose
+	// boundary layers are used to cull faces across the chunk border.
+	Dictionary generate_chunk_mesh_from_data(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const Array &neighbours = Array()
+	);
+
+	// Meshes many chunks across WorkerThreadPool. Results come back in the same
+	// order as chunks, each one shaped like generate_chunk_mesh's Dictionary.
+	// With cull_chunk_borders, chunks in the batch cull against each other.
+	TypedArray<Dictionary> generate_chunk_meshes_batch(
+		const TypedArray<VoxelChunkData> &chunks,
+		const Array &layer_visibility,
+		bool cull_chunk_borders = false
+	);
+
+	// Chunk meshed once for every combination of layer visibility. Faces are
+	// grouped by (layer, hidden_by): hidden_by = -1 holds the faces drawn whenever
+	// the layer is shown, hidden_by = n the faces covered by a voxel on layer n,
+	// drawn only while layer n is hidden. Returns { "groups": Array of
+	// { layer, hidden_by, vertices, normals, colors, uvs, tri_voxel_info } }.
+	Dictionary generate_chunk_layered_mesh(
+		const Ref<VoxelChunkData> &chunk_data,
+		int layer_count,
+		const Array &neighbours = Array()
+	);
+
+	// generate_chunk_mesh_from_data without the ArrayMesh: the mesher output is
+	// encoded once, straight into the uncompressed surface layout, and handed
+	// to RenderingServer.mesh_add_surface. mesh_rid is cleared and reused when
+	// valid, otherwise a new mesh is created (the caller frees it with
+	// RenderingServer.free_rid). Materials come from the instance.
+	// Returns { mesh_rid } plus tri_voxel_info or face_runs.
+	Dictionary generate_chunk_mesh_to_rid(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const RID &mesh_rid,
+		const Array &neighbours = Array()
+	);
+
+	// Full mesh of a chunk that patch_chunk_mesh can later update in place. The
+	// surface is never compressed and carries spare vertices for voxels that grow.
+	// Returns { arraymesh, tri_voxel_info, rebuilt }; padding triangles map to (-1, -1).
+	Dictionary generate_patchable_chunk_mesh(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const Array &neighbours = Array()
+	);
+
+	// Re-emits edited_voxels and their six neighbours into the mesh made by
+	// generate_patchable_chunk_mesh and uploads only the changed vertex ranges.
+	// Call after editing chunk_data. The same ArrayMesh is kept; "rebuilt" is
+	// true when the spare space ran out and the surface was rebuilt (compacted).
+	Dictionary patch_chunk_mesh(
+		const Ref<VoxelChunkData> &chunk_data,
+		const TypedArray<Vector3i> &edited_voxels,
+		const Array &neighbours = Array()
+	);
+
+	// Drops the patch state kept for a chunk (e.g. when it is unloaded)
+	void release_patchable_chunk(const Vector3i &chunk_coord);
+
+	// Concatenates the groups of a generate_chunk_layered_mesh result that are
+	// visible under layer_visibility - no meshing, just copies. Returns
+	// { arraymesh, tri_voxel_info } like generate_chunk_mesh.
+	Dictionary compose_layer_mesh(const Dictionary &layered, const Array &layer_visibility);
+
+	// generate_chunk_mesh_from_data plus a collision representation built from the
+	// solid grid (visible voxels as full cubes) instead of create_trimesh_shape()
+	Dictionary generate_chunk_mesh_with_collision(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		CollisionMode collision_mode,
+		const Array &neighbours = Array()
+	);
+
+	// Walks the voxel grid from origin with a 3D DDA, no physics involved.
+	// chunks: Dictionary of chunk_coord (Vector3i) -> VoxelChunkData of chunk_size
+	// (non-positive components mean VoxelChunkData.DEFAULT_SIZE). Chunks of another
+	// size, or stored under a key other than their chunk_coord, are treated as empty.
+	// Voxels on layers not set in layer_mask are skipped. A voxel whose shape
+	// fills the face the ray enters through is a hit straight away; other shapes
+	// are tested against their unwobbled triangles.
+	// Returns { voxel, chunk_coord, face (DIR_OFFSETS order), normal, position,
+	// distance }, or an empty Dictionary when nothing is hit.
+	Dictionary raycast_voxels(
+		const Dictionary &chunks,
+		const Vector3 &origin,
+		const Vector3 &direction,
+		float max_distance,
+		int64_t layer_mask = -1,
+		const Vector3i &chunk_size = Vector3i(VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE)
+	) const;
+
+	// LOD chain for one chunk, nearest first:
+	// 0 = full wobbled mesh (generate_chunk_mesh_from_data), 1 = greedy quads at
+	// full resolution, 2 = 2x downsampled (majority rule), 3 = 4x downsampled
+	// (any solid cell). Levels 1-3 carry one dominant tile per quad. Each entry
+	// has "arraymesh" and "cell_size".
+	TypedArray<Dictionary> generate_chunk_lod_chain(
+		const Ref<VoxelChunkData> &chunk_data,
+		const Array &layer_visibility,
+		const Array &neighbours = Array()
+	);
+
+	// Index into the LOD chain for a camera distance; lod_distances[i] is the
+	// distance at which level i hands over to level i + 1
+	static int select_lod_level(float distance, const PackedFloat32Array &lod_distances);
+
 	Ref<ArrayMesh> generate_simplified_mesh(
 		const Vector3i &chunk_coord,
 		const Array &voxels,
@@ -144,5 +555,7 @@ public:
 
 } // namespace godot
 
+VARIANT_ENUM_CAST(VoxelMesher::CollisionMode);
+
 #endif // VOXEL_MESHER_H
 
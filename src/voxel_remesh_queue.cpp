@@ -0,0 +1,298 @@
+#include "voxel_remesh_queue.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <algorithm>
+
+using namespace godot;
+
+VoxelRemeshQueue::VoxelRemeshQueue() {
+	worker_count = MAX(1, OS::get_singleton()->get_processor_count() / 2);
+	next_generation = 1;
+	stopping = false;
+}
+
+VoxelRemeshQueue::~VoxelRemeshQueue() {
+	_stop_workers();
+}
+
+void VoxelRemeshQueue::_ready() {
+	set_process(true);
+}
+
+void VoxelRemeshQueue::_exit_tree() {
+	// Workers hold raw pointers into the mesher - never outlive the node in the tree
+	_stop_workers();
+}
+
+void VoxelRemeshQueue::_start_workers() {
+	if (!workers.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopping = false;
+	}
+	for (int i = 0; i < worker_count; i++) {
+		workers.emplace_back(&VoxelRemeshQueue::_worker_loop, this);
+	}
+}
+
+void VoxelRemeshQueue::_stop_workers() {
+	if (workers.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopping = true;
+	}
+	queue_cond.notify_all();
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+void VoxelRemeshQueue::_worker_loop() {
+	VoxelMesher::MeshScratch *scratch = nullptr;
+	VoxelMesher *worker_mesher = nullptr;
+
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			queue_cond.wait(lock, [this] { return stopping || !pending.empty(); });
+			if (stopping) {
+				break;
+			}
+
+			// Closest chunk to the camera first - a linear scan is cheaper than
+			// keeping the list sorted while the camera moves
+			size_t best = 0;
+			real_t best_dist = pending[0].center.distance_squared_to(camera_position);
+			for (size_t i = 1; i < pending.size(); i++) {
+				const real_t dist = pending[i].center.distance_squared_to(camera_position);
+				if (dist < best_dist) {
+					best_dist = dist;
+					best = i;
+				}
+			}
+			job = std::move(pending[best]);
+			pending[best] = std::move(pending.back());
+			pending.pop_back();
+			worker_mesher = mesher.ptr();
+		}
+
+		CompletedJob done;
+		if (worker_mesher != nullptr) {
+			if (scratch == nullptr) {
+				scratch = worker_mesher->_acquire_scratch();
+			}
+			VoxelMesher::ChunkInput input;
+			VoxelMesher::_fill_chunk_input(*job.snapshot.ptr(), input);
+			input.layers_vis = job.layers_vis.data();
+			input.layer_count = (int)job.layers_vis.size();
+			if (job.has_apron) {
+				input.apron = &job.apron;
+			}
+			// Stamps done.output with the config generation it was meshed with
+			worker_mesher->_mesh_chunk(input, *scratch, done.output);
+		}
+		// Hand the job over so the snapshot is only ever freed on the main thread
+		done.job = std::move(job);
+
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			completed.push_back(std::move(done));
+		}
+	}
+
+	if (scratch != nullptr && worker_mesher != nullptr) {
+		worker_mesher->_release_scratch(scratch);
+	}
+}
+
+void VoxelRemeshQueue::_process(double p_delta) {
+	std::vector<CompletedJob> ready;
+	bool requeued = false;
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		if (completed.empty()) {
+			return;
+		}
+		ready.swap(completed);
+
+		// Setters only run on the main thread, so this can't move under us
+		const uint64_t config_generation = mesher.is_valid() ? mesher->mesh_config_generation : 0;
+
+		// Drop stale results: superseded by a newer enqueue, or cancelled
+		for (size_t i = 0; i < ready.size();) {
+			CompletedJob &done = ready[i];
+			auto it = latest_generation.find(done.job.chunk_coord);
+			if (it == latest_generation.end() || it->second != done.job.generation) {
+				done = std::move(ready.back());
+				ready.pop_back();
+				continue;
+			}
+			// Still wanted but meshed with an old config: mesh it again
+			if (mesher.is_valid() && done.output.config_generation != config_generation) {
+				pending.push_back(std::move(done.job));
+				done = std::move(ready.back());
+				ready.pop_back();
+				requeued = true;
+				continue;
+			}
+			latest_generation.erase(it);
+			i++;
+		}
+	}
+	if (requeued) {
+		queue_cond.notify_all();
+	}
+
+	if (mesher.is_null()) {
+		return;
+	}
+	for (CompletedJob &done : ready) {
+		emit_signal("mesh_ready", done.job.chunk_coord, mesher->_make_mesh_result(done.output));
+	}
+}
+
+void VoxelRemeshQueue::set_mesher(const Ref<VoxelMesher> &p_mesher) {
+	// Scratch arenas belong to the mesher, so workers restart around a swap
+	_stop_workers();
+	mesher = p_mesher;
+}
+
+Ref<VoxelMesher> VoxelRemeshQueue::get_mesher() const {
+	return mesher;
+}
+
+void VoxelRemeshQueue::set_layer_visibility(const Array &p_layer_visibility) {
+	VoxelMesher::_unpack_layer_visibility(p_layer_visibility, layers_vis);
+}
+
+void VoxelRemeshQueue::set_camera_position(const Vector3 &p_position) {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	camera_position = p_position;
+}
+
+void VoxelRemeshQueue::set_worker_count(int p_count) {
+	const bool running = !workers.empty();
+	_stop_workers();
+	worker_count = MAX(1, p_count);
+	if (running) {
+		_start_workers();
+	}
+}
+
+int VoxelRemeshQueue::get_worker_count() const {
+	return worker_count;
+}
+
+void VoxelRemeshQueue::enqueue(const Ref<VoxelChunkData> &p_chunk, const Array &p_neighbours) {
+	ERR_FAIL_COND_MSG(p_chunk.is_null(), "VoxelRemeshQueue.enqueue: chunk is null");
+	ERR_FAIL_COND_MSG(mesher.is_null(), "VoxelRemeshQueue.enqueue: no mesher set");
+
+	// Snapshot now so GDScript can keep editing the live chunk
+	Ref<VoxelChunkData> snapshot = p_chunk->duplicate_chunk();
+	const Vector3i coord = p_chunk->get_chunk_coord();
+	const Vector3i size = p_chunk->get_size();
+	const Vector3 center(
+		(coord.x + 0.5f) * size.x,
+		(coord.y + 0.5f) * size.y,
+		(coord.z + 0.5f) * size.z
+	);
+
+	// Neighbour boundary layers are tiny, so they are copied now as well
+	VoxelMesher::ChunkApron apron;
+	const bool has_apron = !p_neighbours.is_empty();
+	if (has_apron) {
+		VoxelMesher::ChunkInput input;
+		VoxelMesher::_fill_chunk_input(*p_chunk.ptr(), input);
+		input.layers_vis = layers_vis.data();
+		input.layer_count = (int)layers_vis.size();
+
+		mesher->_build_apron_from_array(p_neighbours, input, apron);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		const uint64_t generation = next_generation++;
+		latest_generation[coord] = generation;
+
+		// Coalesce: a chunk that is still waiting just gets its snapshot replaced
+		bool coalesced = false;
+		for (Job &job : pending) {
+			if (job.chunk_coord == coord) {
+				job.generation = generation;
+				job.snapshot = snapshot;
+				job.layers_vis = layers_vis;
+				job.apron = apron;
+				job.has_apron = has_apron;
+				coalesced = true;
+				break;
+			}
+		}
+		if (!coalesced) {
+			Job job;
+			job.chunk_coord = coord;
+			job.generation = generation;
+			job.center = center;
+			job.snapshot = snapshot;
+			job.layers_vis = layers_vis;
+			job.apron = apron;
+			job.has_apron = has_apron;
+			pending.push_back(std::move(job));
+		}
+	}
+
+	_start_workers();
+	queue_cond.notify_one();
+}
+
+bool VoxelRemeshQueue::cancel(const Vector3i &p_chunk_coord) {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	// Forgetting the generation also drops a result that is already in flight
+	const bool known = latest_generation.erase(p_chunk_coord) > 0;
+	for (size_t i = 0; i < pending.size(); i++) {
+		if (pending[i].chunk_coord == p_chunk_coord) {
+			pending[i] = std::move(pending.back());
+			pending.pop_back();
+			break;
+		}
+	}
+	return known;
+}
+
+void VoxelRemeshQueue::cancel_all() {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	pending.clear();
+	latest_generation.clear();
+}
+
+bool VoxelRemeshQueue::is_pending(const Vector3i &p_chunk_coord) {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	return latest_generation.find(p_chunk_coord) != latest_generation.end();
+}
+
+int VoxelRemeshQueue::get_pending_count() {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	return (int)latest_generation.size();
+}
+
+void VoxelRemeshQueue::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_mesher", "mesher"), &VoxelRemeshQueue::set_mesher);
+	ClassDB::bind_method(D_METHOD("get_mesher"), &VoxelRemeshQueue::get_mesher);
+	ClassDB::bind_method(D_METHOD("set_layer_visibility", "layer_visibility"), &VoxelRemeshQueue::set_layer_visibility);
+	ClassDB::bind_method(D_METHOD("set_camera_position", "position"), &VoxelRemeshQueue::set_camera_position);
+	ClassDB::bind_method(D_METHOD("set_worker_count", "count"), &VoxelRemeshQueue::set_worker_count);
+	ClassDB::bind_method(D_METHOD("get_worker_count"), &VoxelRemeshQueue::get_worker_count);
+	ClassDB::bind_method(D_METHOD("enqueue", "chunk", "neighbours"), &VoxelRemeshQueue::enqueue, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("cancel", "chunk_coord"), &VoxelRemeshQueue::cancel);
+	ClassDB::bind_method(D_METHOD("cancel_all"), &VoxelRemeshQueue::cancel_all);
+	ClassDB::bind_method(D_METHOD("is_pending", "chunk_coord"), &VoxelRemeshQueue::is_pending);
+	ClassDB::bind_method(D_METHOD("get_pending_count"), &VoxelRemeshQueue::get_pending_count);
+
+	// result has the same shape as VoxelMesher.generate_chunk_mesh()
+	ADD_SIGNAL(MethodInfo("mesh_ready", PropertyInfo(Variant::VECTOR3I, "chunk_coord"), PropertyInfo(Variant::DICTIONARY, "result")));
+}
@@ -0,0 +1,93 @@
+#ifndef VOXEL_REMESH_QUEUE_H
+#define VOXEL_REMESH_QUEUE_H
+
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include "voxel_chunk_data.h"
+#include "voxel_mesher.h"
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+namespace godot {
+
+// Background remesh queue sitting next to VoxelMesher.
+// enqueue() snapshots a chunk and returns immediately; worker threads mesh the
+// pending chunk closest to the camera first, and mesh_ready is emitted from
+// _process() on the main thread. Re-enqueueing a chunk that is still pending
+// replaces its snapshot, and any result that is older than the latest request
+// (or was cancelled) is dropped instead of emitted. A result meshed before the
+// mesher's config last changed (parse_shapes, output options, ...) goes back
+// into the queue instead.
+class VoxelRemeshQueue : public Node {
+	GDCLASS(VoxelRemeshQueue, Node)
+
+private:
+	struct Job {
+		Vector3i chunk_coord;
+		uint64_t generation;
+		Vector3 center; // world-space chunk center, for distance sorting
+		Ref<VoxelChunkData> snapshot;
+		std::vector<uint8_t> layers_vis;
+		VoxelMesher::ChunkApron apron;
+		bool has_apron = false;
+	};
+
+	struct CompletedJob {
+		Job job; // snapshot is released on the main thread, or requeued
+		VoxelMesher::MeshOutput output;
+	};
+
+	Ref<VoxelMesher> mesher;
+	std::vector<uint8_t> layers_vis;
+	int worker_count;
+
+	// Guarded by queue_mutex
+	std::mutex queue_mutex;
+	std::condition_variable queue_cond;
+	std::vector<Job> pending;
+	std::vector<CompletedJob> completed;
+	std::map<Vector3i, uint64_t> latest_generation;
+	Vector3 camera_position;
+	uint64_t next_generation;
+	bool stopping;
+
+	std::vector<std::thread> workers;
+
+	void _start_workers();
+	void _stop_workers();
+	void _worker_loop();
+
+protected:
+	static void _bind_methods();
+
+public:
+	VoxelRemeshQueue();
+	~VoxelRemeshQueue();
+
+	void _ready() override;
+	void _process(double p_delta) override;
+	void _exit_tree() override;
+
+	void set_mesher(const Ref<VoxelMesher> &p_mesher);
+	Ref<VoxelMesher> get_mesher() const;
+	void set_layer_visibility(const Array &p_layer_visibility);
+	void set_camera_position(const Vector3 &p_position);
+	void set_worker_count(int p_count);
+	int get_worker_count() const;
+
+	void enqueue(const Ref<VoxelChunkData> &p_chunk, const Array &p_neighbours = Array());
+	bool cancel(const Vector3i &p_chunk_coord);
+	void cancel_all();
+	bool is_pending(const Vector3i &p_chunk_coord);
+	int get_pending_count();
+};
+
+} // namespace godot
+
+#endif // VOXEL_REMESH_QUEUE_H
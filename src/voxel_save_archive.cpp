@@ -0,0 +1,361 @@
+#include "voxel_save_archive.h"
+#include "binary_stream.h"
+#include "example_class.h"
+#include "voxel_stream_codec.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <algorithm>
+#include <array>
+
+using namespace godot;
+
+// Standard CRC-32 (IEEE, reflected), as used by zip and PNG
+static uint32_t crc32(const uint8_t *p_data, int64_t p_len) {
+	static const std::array<uint32_t, 256> table = [] {
+		std::array<uint32_t, 256> t;
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			}
+			t[i] = c;
+		}
+		return t;
+	}();
+	uint32_t crc = 0xffffffffu;
+	for (int64_t i = 0; i < p_len; i++) {
+		crc = table[(crc ^ p_data[i]) & 0xff] ^ (crc >> 8);
+	}
+	return crc ^ 0xffffffffu;
+}
+
+VoxelSaveArchive::VoxelSaveArchive() {
+	chunk_size = Vector3i(VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE);
+	flags = 0;
+}
+
+VoxelSaveArchive::~VoxelSaveArchive() {
+	close();
+}
+
+Error VoxelSaveArchive::save(const String &p_path, const Array &p_savedat, const Dictionary &p_chunks, const Vector3i &p_chunk_size, bool p_compress) {
+	ERR_FAIL_COND_V_MSG(p_savedat.size() != 5, ERR_INVALID_PARAMETER, vformat("VoxelSaveArchive.save: Invalid savedat array size (expected 5, got %d)", p_savedat.size()));
+	ERR_FAIL_COND_V_MSG(p_chunk_size.x <= 0 || p_chunk_size.y <= 0 || p_chunk_size.z <= 0 || p_chunk_size.x > 0xffff || p_chunk_size.y > 0xffff || p_chunk_size.z > 0xffff,
+			ERR_INVALID_PARAMETER, "VoxelSaveArchive.save: chunk_size out of range");
+
+	// Resolve every chunk before touching the file, so a bad value cannot leave half a save behind
+	Array keys = p_chunks.keys();
+	std::vector<Ref<VoxelChunkData>> chunks;
+	chunks.reserve(keys.size());
+	for (int64_t i = 0; i < keys.size(); i++) {
+		const Vector3i coord = keys[i];
+		const Variant value = p_chunks[keys[i]];
+		Ref<VoxelChunkData> chunk;
+		if (value.get_type() == Variant::OBJECT) {
+			chunk = value;
+			ERR_FAIL_COND_V_MSG(chunk.is_null(), ERR_INVALID_PARAMETER, "VoxelSaveArchive.save: chunk values must be VoxelChunkData or [positions, records]");
+			ERR_FAIL_COND_V_MSG(chunk->get_chunk_coord() != coord || chunk->get_size() != p_chunk_size, ERR_INVALID_PARAMETER,
+					vformat("VoxelSaveArchive.save: VoxelChunkData stored under %s does not match its coordinate or the chunk size", coord));
+		} else {
+			Array pair = value;
+			ERR_FAIL_COND_V_MSG(pair.size() != 2, ERR_INVALID_PARAMETER, "VoxelSaveArchive.save: chunk values must be VoxelChunkData or [positions, records]");
+			chunk.instantiate();
+			chunk->setup(coord, p_chunk_size.x, p_chunk_size.y, p_chunk_size.z);
+			chunk->set_from_packed(pair[0], pair[1]);
+		}
+		if (chunk->get_voxel_count() > 0) {
+			chunks.push_back(chunk);
+		}
+	}
+
+	Ref<OeufSerializer> serializer;
+	serializer.instantiate();
+	const PackedByteArray level_block = serializer->serialize_game_data_chunks(p_savedat, Dictionary());
+	ERR_FAIL_COND_V(level_block.is_empty(), ERR_INVALID_PARAMETER);
+
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(f.is_null(), FileAccess::get_open_error(), vformat("VoxelSaveArchive.save: Cannot open %s for writing", p_path));
+
+	// Header is written last, once the offsets are known
+	PackedByteArray placeholder;
+	placeholder.resize(HEADER_SIZE);
+	placeholder.fill(0);
+	f->store_buffer(placeholder);
+
+	const uint64_t level_offset = f->get_position();
+	f->store_buffer(level_block);
+
+	BinaryStreamCore index;
+	index.reserve((int64_t)chunks.size() * INDEX_ENTRY_SIZE);
+	BinaryStreamCore block;
+	for (const Ref<VoxelChunkData> &chunk : chunks) {
+		block.clear();
+		VoxelStreamCodec::encode(block, chunk->get_positions_ptr(), chunk->get_records_ptr(), chunk->get_voxel_count());
+		const PackedByteArray raw = block.get_data();
+		PackedByteArray stored = raw;
+		if (p_compress) {
+			// Only kept when it actually helps, the reader tells the two apart by the lengths
+			const PackedByteArray packed = raw.compress(FileAccess::COMPRESSION_ZSTD);
+			if (packed.size() > 0 && packed.size() < raw.size()) {
+				stored = packed;
+			}
+		}
+
+		const Vector3i coord = chunk->get_chunk_coord();
+		index.put_s32(coord.x);
+		index.put_s32(coord.y);
+		index.put_s32(coord.z);
+		index.put_u64(f->get_position());
+		index.put_u32((uint32_t)stored.size());
+		index.put_u32((uint32_t)raw.size());
+		index.put_u32(crc32(stored.ptr(), stored.size()));
+		index.put_u32((uint32_t)chunk->get_voxel_count());
+		f->store_buffer(stored);
+	}
+
+	const uint64_t index_offset = f->get_position();
+	const PackedByteArray index_bytes = index.get_data();
+	f->store_buffer(index_bytes);
+
+	BinaryStreamCore header;
+	header.put_u32(MAGIC);
+	header.put_u16(FORMAT_VERSION);
+	header.put_u8(p_compress ? FLAG_ZSTD : 0);
+	header.put_u8(0);
+	header.put_u16((uint16_t)p_chunk_size.x);
+	header.put_u16((uint16_t)p_chunk_size.y);
+	header.put_u16((uint16_t)p_chunk_size.z);
+	header.put_u16(0);
+	header.put_u32((uint32_t)chunks.size());
+	header.put_u64(index_offset);
+	header.put_u32((uint32_t)index_bytes.size());
+	header.put_u32(crc32(index_bytes.ptr(), index_bytes.size()));
+	header.put_u64(level_offset);
+	header.put_u32((uint32_t)level_block.size());
+	f->seek(0);
+	f->store_buffer(header.get_data());
+
+	const Error err = f->get_error();
+	f->close();
+	return err;
+}
+
+Error VoxelSaveArchive::open(const String &p_path) {
+	close();
+
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(f.is_null(), FileAccess::get_open_error(), vformat("VoxelSaveArchive.open: Cannot open %s", p_path));
+	const uint64_t file_length = f->get_length();
+	ERR_FAIL_COND_V_MSG(file_length < (uint64_t)HEADER_SIZE, ERR_FILE_CORRUPT, vformat("VoxelSaveArchive.open: %s is too short", p_path));
+
+	BinaryStreamCore header(f->get_buffer(HEADER_SIZE));
+	ERR_FAIL_COND_V_MSG(header.get_u32() != MAGIC, ERR_FILE_UNRECOGNIZED, vformat("VoxelSaveArchive.open: %s is not a voxel save archive", p_path));
+	const int version = header.get_u16();
+	ERR_FAIL_COND_V_MSG(version > FORMAT_VERSION, ERR_FILE_UNRECOGNIZED, vformat("VoxelSaveArchive.open: %s has format version %d, newer than this build reads", p_path, version));
+	const uint8_t file_flags = header.get_u8();
+	header.get_u8();
+	Vector3i file_chunk_size;
+	file_chunk_size.x = header.get_u16();
+	file_chunk_size.y = header.get_u16();
+	file_chunk_size.z = header.get_u16();
+	header.get_u16();
+	const uint32_t chunk_count = header.get_u32();
+	const uint64_t index_offset = header.get_u64();
+	const uint32_t index_length = header.get_u32();
+	const uint32_t index_crc = header.get_u32();
+	const uint64_t level_offset = header.get_u64();
+	const uint32_t level_length = header.get_u32();
+	ERR_FAIL_COND_V_MSG(header.has_error() || file_chunk_size.x == 0 || file_chunk_size.y == 0 || file_chunk_size.z == 0 ||
+					(uint64_t)chunk_count * INDEX_ENTRY_SIZE != index_length ||
+					index_offset > file_length || index_length > file_length - index_offset ||
+					level_offset > file_length || level_length > file_length - level_offset,
+			ERR_FILE_CORRUPT, vformat("VoxelSaveArchive.open: Corrupt header in %s", p_path));
+
+	// Index: the only part whose size grows with the level, and only by INDEX_ENTRY_SIZE per chunk
+	f->seek(index_offset);
+	const PackedByteArray index_bytes = f->get_buffer(index_length);
+	ERR_FAIL_COND_V_MSG(index_bytes.size() != index_length || crc32(index_bytes.ptr(), index_bytes.size()) != index_crc,
+			ERR_FILE_CORRUPT, vformat("VoxelSaveArchive.open: Corrupt chunk index in %s", p_path));
+
+	std::vector<ChunkEntry> file_entries(chunk_count);
+	std::map<Vector3i, size_t> file_entry_by_coord;
+	BinaryStreamCore index(index_bytes);
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		ChunkEntry &entry = file_entries[i];
+		// Separate statements, argument evaluation order is unspecified
+		const int32_t x = index.get_s32();
+		const int32_t y = index.get_s32();
+		const int32_t z = index.get_s32();
+		entry.coord = Vector3i(x, y, z);
+		entry.offset = index.get_u64();
+		entry.stored_length = index.get_u32();
+		entry.raw_length = index.get_u32();
+		entry.crc = index.get_u32();
+		entry.voxel_count = index.get_u32();
+		ERR_FAIL_COND_V_MSG(entry.offset > file_length || entry.stored_length > file_length - entry.offset,
+				ERR_FILE_CORRUPT, vformat("VoxelSaveArchive.open: Chunk %s points outside %s", entry.coord, p_path));
+		file_entry_by_coord[entry.coord] = i;
+	}
+
+	f->seek(level_offset);
+	const PackedByteArray level_block = f->get_buffer(level_length);
+	Ref<OeufSerializer> serializer;
+	serializer.instantiate();
+	const Array file_level_data = serializer->deserialize_game_data_packed(level_block);
+	ERR_FAIL_COND_V_MSG(file_level_data.is_empty(), ERR_FILE_CORRUPT, vformat("VoxelSaveArchive.open: Corrupt level block in %s", p_path));
+
+	file = f;
+	chunk_size = file_chunk_size;
+	flags = file_flags;
+	entries.swap(file_entries);
+	entry_by_coord.swap(file_entry_by_coord);
+	level_data = file_level_data;
+	return OK;
+}
+
+void VoxelSaveArchive::close() {
+	if (file.is_valid()) {
+		file->close();
+		file.unref();
+	}
+	entries.clear();
+	entry_by_coord.clear();
+	level_data = Array();
+	flags = 0;
+}
+
+bool VoxelSaveArchive::is_open() const {
+	return file.is_valid();
+}
+
+Array VoxelSaveArchive::get_level_data() const {
+	return level_data;
+}
+
+Vector3i VoxelSaveArchive::get_chunk_size() const {
+	return chunk_size;
+}
+
+int VoxelSaveArchive::get_chunk_count() const {
+	return (int)entries.size();
+}
+
+TypedArray<Vector3i> VoxelSaveArchive::get_chunk_coords() const {
+	TypedArray<Vector3i> result;
+	result.resize(entries.size());
+	for (size_t i = 0; i < entries.size(); i++) {
+		result[i] = entries[i].coord;
+	}
+	return result;
+}
+
+bool VoxelSaveArchive::has_chunk(const Vector3i &p_coord) const {
+	return entry_by_coord.find(p_coord) != entry_by_coord.end();
+}
+
+int VoxelSaveArchive::get_chunk_voxel_count(const Vector3i &p_coord) const {
+	auto it = entry_by_coord.find(p_coord);
+	return it == entry_by_coord.end() ? 0 : (int)entries[it->second].voxel_count;
+}
+
+AABB VoxelSaveArchive::_chunk_aabb(const Vector3i &p_coord) const {
+	return AABB(
+			Vector3(p_coord.x * chunk_size.x, p_coord.y * chunk_size.y, p_coord.z * chunk_size.z),
+			Vector3(chunk_size.x, chunk_size.y, chunk_size.z));
+}
+
+Ref<VoxelChunkData> VoxelSaveArchive::_load_entry(const ChunkEntry &p_entry) {
+	file->seek(p_entry.offset);
+	const PackedByteArray stored = file->get_buffer(p_entry.stored_length);
+	ERR_FAIL_COND_V_MSG(stored.size() != p_entry.stored_length || crc32(stored.ptr(), stored.size()) != p_entry.crc,
+			Ref<VoxelChunkData>(), vformat("VoxelSaveArchive: Checksum mismatch in chunk %s", p_entry.coord));
+
+	const PackedByteArray raw = p_entry.stored_length == p_entry.raw_length ? stored : stored.decompress(p_entry.raw_length, FileAccess::COMPRESSION_ZSTD);
+	ERR_FAIL_COND_V_MSG(raw.size() != p_entry.raw_length, Ref<VoxelChunkData>(), vformat("VoxelSaveArchive: Cannot decompress chunk %s", p_entry.coord));
+
+	BinaryStreamCore reader(raw);
+	std::vector<Vector3i> positions;
+	std::vector<VoxelData> records;
+	const bool ok = VoxelStreamCodec::decode(reader, positions, records);
+	ERR_FAIL_COND_V_MSG(!ok || reader.get_available_bytes() != 0 || positions.size() != p_entry.voxel_count,
+			Ref<VoxelChunkData>(), vformat("VoxelSaveArchive: Corrupt voxel stream in chunk %s", p_entry.coord));
+
+	Ref<VoxelChunkData> chunk;
+	chunk.instantiate();
+	chunk->setup(p_entry.coord, chunk_size.x, chunk_size.y, chunk_size.z);
+	for (size_t i = 0; i < positions.size(); i++) {
+		const VoxelData &vd = records[i];
+		chunk->add_voxel_fields(positions[i], vd.shape_type, vd.tx, vd.ty, vd.rot, vd.vflip, vd.layer);
+	}
+	return chunk;
+}
+
+Dictionary VoxelSaveArchive::_load_entries(std::vector<const ChunkEntry *> &p_selected) {
+	// In file order, so a region load is one forward pass over the file
+	std::sort(p_selected.begin(), p_selected.end(), [](const ChunkEntry *a, const ChunkEntry *b) {
+		return a->offset < b->offset;
+	});
+	Dictionary result;
+	for (const ChunkEntry *entry : p_selected) {
+		Ref<VoxelChunkData> chunk = _load_entry(*entry);
+		if (chunk.is_valid()) {
+			result[entry->coord] = chunk;
+		}
+	}
+	return result;
+}
+
+Ref<VoxelChunkData> VoxelSaveArchive::load_chunk(const Vector3i &p_coord) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), Ref<VoxelChunkData>(), "VoxelSaveArchive.load_chunk: no archive is open");
+	auto it = entry_by_coord.find(p_coord);
+	if (it == entry_by_coord.end()) {
+		return Ref<VoxelChunkData>();
+	}
+	return _load_entry(entries[it->second]);
+}
+
+Dictionary VoxelSaveArchive::load_chunks_in_aabb(const AABB &p_aabb) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), Dictionary(), "VoxelSaveArchive.load_chunks_in_aabb: no archive is open");
+	std::vector<const ChunkEntry *> selected;
+	for (const ChunkEntry &entry : entries) {
+		if (_chunk_aabb(entry.coord).intersects(p_aabb)) {
+			selected.push_back(&entry);
+		}
+	}
+	return _load_entries(selected);
+}
+
+Dictionary VoxelSaveArchive::load_chunks_in_radius(const Vector3 &p_center, float p_radius) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), Dictionary(), "VoxelSaveArchive.load_chunks_in_radius: no archive is open");
+	std::vector<const ChunkEntry *> selected;
+	const float radius_sq = p_radius * p_radius;
+	for (const ChunkEntry &entry : entries) {
+		// Distance from the centre to the nearest point of the chunk's box
+		const AABB box = _chunk_aabb(entry.coord);
+		const Vector3 end = box.get_end();
+		const Vector3 nearest(
+				CLAMP(p_center.x, box.position.x, end.x),
+				CLAMP(p_center.y, box.position.y, end.y),
+				CLAMP(p_center.z, box.position.z, end.z));
+		if (nearest.distance_squared_to(p_center) <= radius_sq) {
+			selected.push_back(&entry);
+		}
+	}
+	return _load_entries(selected);
+}
+
+void VoxelSaveArchive::_bind_methods() {
+	ClassDB::bind_static_method("VoxelSaveArchive", D_METHOD("save", "path", "savedat", "chunks", "chunk_size", "compress"), &VoxelSaveArchive::save,
+			DEFVAL(Vector3i(VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE, VoxelChunkData::DEFAULT_SIZE)), DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("open", "path"), &VoxelSaveArchive::open);
+	ClassDB::bind_method(D_METHOD("close"), &VoxelSaveArchive::close);
+	ClassDB::bind_method(D_METHOD("is_open"), &VoxelSaveArchive::is_open);
+	ClassDB::bind_method(D_METHOD("get_level_data"), &VoxelSaveArchive::get_level_data);
+	ClassDB::bind_method(D_METHOD("get_chunk_size"), &VoxelSaveArchive::get_chunk_size);
+	ClassDB::bind_method(D_METHOD("get_chunk_count"), &VoxelSaveArchive::get_chunk_count);
+	ClassDB::bind_method(D_METHOD("get_chunk_coords"), &VoxelSaveArchive::get_chunk_coords);
+	ClassDB::bind_method(D_METHOD("has_chunk", "chunk_coord"), &VoxelSaveArchive::has_chunk);
+	ClassDB::bind_method(D_METHOD("get_chunk_voxel_count", "chunk_coord"), &VoxelSaveArchive::get_chunk_voxel_count);
+	ClassDB::bind_method(D_METHOD("load_chunk", "chunk_coord"), &VoxelSaveArchive::load_chunk);
+	ClassDB::bind_method(D_METHOD("load_chunks_in_aabb", "aabb"), &VoxelSaveArchive::load_chunks_in_aabb);
+	ClassDB::bind_method(D_METHOD("load_chunks_in_radius", "center", "radius"), &VoxelSaveArchive::load_chunks_in_radius);
+}
@@ -0,0 +1,96 @@
+#ifndef VOXEL_SAVE_ARCHIVE_H
+#define VOXEL_SAVE_ARCHIVE_H
+
+#include "voxel_chunk_data.h"
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/global_constants.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+namespace godot {
+
+// Chunk-indexed save file, so a level can be opened without decoding every voxel.
+// Layout (little-endian):
+//   header (HEADER_SIZE bytes): magic, format version, flags, chunk size,
+//     chunk count, index offset/length/CRC32, level block offset/length
+//   level block: a serialize_game_data_chunks() save with no voxels
+//     (version, layers, cameras, entities)
+//   chunk blocks: one VoxelStreamCodec stream per chunk, zstd-compressed when
+//     that is smaller (PackedByteArray.compress)
+//   index: INDEX_ENTRY_SIZE bytes per chunk - coord, offset, stored and raw
+//     length, CRC32 of the stored bytes, voxel count
+// open() reads the header, index and level block only. Chunk blocks are read
+// with a seek and one get_buffer() each, the first time something asks for them.
+class VoxelSaveArchive : public RefCounted {
+	GDCLASS(VoxelSaveArchive, RefCounted)
+
+public:
+	static const uint32_t MAGIC = 0x4158564f; // "OVXA"
+	static const int FORMAT_VERSION = 1;
+	static const int HEADER_SIZE = 48;
+	static const int INDEX_ENTRY_SIZE = 32;
+	static const uint8_t FLAG_ZSTD = 1;
+
+private:
+	struct ChunkEntry {
+		Vector3i coord;
+		uint64_t offset;
+		uint32_t stored_length; // == raw_length when the block is not compressed
+		uint32_t raw_length;
+		uint32_t crc;
+		uint32_t voxel_count;
+	};
+
+	Ref<FileAccess> file;
+	Vector3i chunk_size;
+	uint8_t flags;
+	std::vector<ChunkEntry> entries;
+	std::map<Vector3i, size_t> entry_by_coord;
+	Array level_data;
+
+	// Chunk's world-space box, for the region queries
+	AABB _chunk_aabb(const Vector3i &p_coord) const;
+	Ref<VoxelChunkData> _load_entry(const ChunkEntry &p_entry);
+	Dictionary _load_entries(std::vector<const ChunkEntry *> &p_selected);
+
+protected:
+	static void _bind_methods();
+
+public:
+	VoxelSaveArchive();
+	~VoxelSaveArchive();
+
+	// Writes savedat (as for OeufSerializer.serialize_game_data_chunks, voxel_data is not
+	// used) and chunks (chunk_coord -> VoxelChunkData or [positions, records]) to path.
+	// Voxels outside their chunk's bounds are dropped.
+	static Error save(const String &p_path, const Array &p_savedat, const Dictionary &p_chunks, const Vector3i &p_chunk_size, bool p_compress);
+
+	Error open(const String &p_path);
+	void close();
+	bool is_open() const;
+
+	// The savedat Array without voxels, as returned by OeufSerializer.deserialize_game_data_packed
+	Array get_level_data() const;
+	Vector3i get_chunk_size() const;
+	int get_chunk_count() const;
+	TypedArray<Vector3i> get_chunk_coords() const;
+	bool has_chunk(const Vector3i &p_coord) const;
+	int get_chunk_voxel_count(const Vector3i &p_coord) const;
+
+	// Null when the chunk is not in the file or its block is corrupt
+	Ref<VoxelChunkData> load_chunk(const Vector3i &p_coord);
+	// chunk_coord -> VoxelChunkData for every stored chunk whose bounds touch the region
+	Dictionary load_chunks_in_aabb(const AABB &p_aabb);
+	Dictionary load_chunks_in_radius(const Vector3 &p_center, float p_radius);
+};
+
+} // namespace godot
+
+#endif // VOXEL_SAVE_ARCHIVE_H
@@ -0,0 +1,225 @@
+#include "voxel_stream_codec.h"
+#include <algorithm>
+#include <unordered_map>
+
+using namespace godot;
+
+static inline int floor_div(int a, int b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// The 5 property bytes of a voxel as saved since version 0
+static inline uint64_t property_key(const VoxelData &p_record) {
+	const uint8_t rot_vflip = static_cast<uint8_t>((p_record.rot & 3) + (p_record.vflip ? 4 : 0));
+	return (uint64_t)p_record.shape_type |
+			((uint64_t)(uint8_t)p_record.tx << 8) |
+			((uint64_t)(uint8_t)p_record.ty << 16) |
+			((uint64_t)rot_vflip << 24) |
+			((uint64_t)(uint8_t)p_record.layer << 32);
+}
+
+void VoxelStreamCodec::encode(BinaryStreamCore &p_writer, const Vector3i *p_positions, const VoxelData *p_records, int64_t p_count) {
+	struct Item {
+		int32_t bx, by, bz;
+		uint32_t code;
+		uint32_t index;
+	};
+	std::vector<Item> items(p_count);
+	for (int64_t i = 0; i < p_count; i++) {
+		const Vector3i &p = p_positions[i];
+		Item &item = items[i];
+		item.bx = floor_div(p.x, BLOCK_SIZE);
+		item.by = floor_div(p.y, BLOCK_SIZE);
+		item.bz = floor_div(p.z, BLOCK_SIZE);
+		item.code = morton_encode(p.x - item.bx * BLOCK_SIZE, p.y - item.by * BLOCK_SIZE, p.z - item.bz * BLOCK_SIZE);
+		item.index = (uint32_t)i;
+	}
+	std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+		if (a.bx != b.bx) {
+			return a.bx < b.bx;
+		}
+		if (a.by != b.by) {
+			return a.by < b.by;
+		}
+		if (a.bz != b.bz) {
+			return a.bz < b.bz;
+		}
+		if (a.code != b.code) {
+			return a.code < b.code;
+		}
+		return a.index < b.index;
+	});
+	// Spans cannot describe the same code twice, keep the first voxel at each position
+	items.erase(std::unique(items.begin(), items.end(), [](const Item &a, const Item &b) {
+		return a.bx == b.bx && a.by == b.by && a.bz == b.bz && a.code == b.code;
+	}),
+			items.end());
+
+	// Palette of distinct property records, most used first so common tiles get 1-byte indices
+	std::unordered_map<uint64_t, uint32_t> key_counts;
+	for (const Item &item : items) {
+		key_counts[property_key(p_records[item.index])]++;
+	}
+	std::vector<std::pair<uint64_t, uint32_t>> palette(key_counts.begin(), key_counts.end());
+	std::sort(palette.begin(), palette.end(), [](const std::pair<uint64_t, uint32_t> &a, const std::pair<uint64_t, uint32_t> &b) {
+		return a.second != b.second ? a.second > b.second : a.first < b.first;
+	});
+	std::unordered_map<uint64_t, uint32_t> palette_index;
+	palette_index.reserve(palette.size());
+
+	p_writer.put_varint(items.size());
+	p_writer.put_varint(palette.size());
+	for (size_t i = 0; i < palette.size(); i++) {
+		const uint64_t key = palette[i].first;
+		palette_index[key] = (uint32_t)i;
+		for (int b = 0; b < 5; b++) {
+			p_writer.put_u8(static_cast<uint8_t>(key >> (8 * b)));
+		}
+	}
+
+	std::vector<uint32_t> item_palette(items.size());
+	for (size_t i = 0; i < items.size(); i++) {
+		item_palette[i] = palette_index[property_key(p_records[items[i].index])];
+	}
+
+	// Blocks are contiguous after the sort
+	std::vector<size_t> block_starts;
+	for (size_t i = 0; i < items.size(); i++) {
+		if (i == 0 || items[i].bx != items[i - 1].bx || items[i].by != items[i - 1].by || items[i].bz != items[i - 1].bz) {
+			block_starts.push_back(i);
+		}
+	}
+	block_starts.push_back(items.size());
+	p_writer.put_varint(block_starts.size() - 1);
+
+	std::vector<std::pair<uint32_t, uint32_t>> spans;
+	int32_t prev_bx = 0, prev_by = 0, prev_bz = 0;
+	for (size_t b = 0; b + 1 < block_starts.size(); b++) {
+		const size_t begin = block_starts[b];
+		const size_t end = block_starts[b + 1];
+		const Item &first = items[begin];
+		p_writer.put_zigzag((int64_t)first.bx - prev_bx);
+		p_writer.put_zigzag((int64_t)first.by - prev_by);
+		p_writer.put_zigzag((int64_t)first.bz - prev_bz);
+		prev_bx = first.bx;
+		prev_by = first.by;
+		prev_bz = first.bz;
+
+		// Runs of consecutive Morton codes, as (codes skipped since the last run, length - 1)
+		spans.clear();
+		uint32_t next_code = 0;
+		size_t i = begin;
+		while (i < end) {
+			const uint32_t start = items[i].code;
+			size_t j = i + 1;
+			while (j < end && items[j].code == items[j - 1].code + 1) {
+				j++;
+			}
+			spans.push_back(std::make_pair(start - next_code, (uint32_t)(j - i - 1)));
+			next_code = items[j - 1].code + 1;
+			i = j;
+		}
+		p_writer.put_varint(spans.size());
+		for (const std::pair<uint32_t, uint32_t> &span : spans) {
+			p_writer.put_varint(span.first);
+			p_writer.put_varint(span.second);
+		}
+
+		// Properties in the same order, run-length encoded over palette indices
+		i = begin;
+		while (i < end) {
+			const uint32_t index = item_palette[i];
+			size_t j = i + 1;
+			while (j < end && item_palette[j] == index) {
+				j++;
+			}
+			p_writer.put_varint(j - i - 1);
+			p_writer.put_varint(index);
+			i = j;
+		}
+	}
+}
+
+bool VoxelStreamCodec::decode(BinaryStreamCore &p_reader, std::vector<Vector3i> &r_positions, std::vector<VoxelData> &r_records) {
+	const uint64_t voxel_count = p_reader.get_varint();
+	const uint64_t palette_size = p_reader.get_varint();
+	// Divided rather than multiplied, a huge palette_size would wrap the product
+	if (voxel_count > INT32_MAX || palette_size > (uint64_t)p_reader.get_available_bytes() / 5) {
+		p_reader.set_error(ERR_INVALID_DATA);
+		return false;
+	}
+
+	std::vector<VoxelData> palette(palette_size);
+	for (uint64_t i = 0; i < palette_size; i++) {
+		VoxelData &vd = palette[i];
+		vd.shape_type = p_reader.get_u8(); // blocktype
+		vd.tx = p_reader.get_u8();
+		vd.ty = p_reader.get_u8();
+		const uint8_t rot_vflip = p_reader.get_u8();
+		vd.rot = rot_vflip & 3;
+		vd.vflip = (rot_vflip & 4) != 0;
+		vd.layer = (int8_t)p_reader.get_u8();
+	}
+
+	const uint64_t block_count = p_reader.get_varint();
+	// A solid block takes a handful of bytes, so the count cannot be checked against the
+	// buffer size; only reserve what a corrupt header could not blow up
+	const size_t base = r_positions.size();
+	r_positions.reserve(base + (size_t)MIN(voxel_count, (uint64_t)(1 << 22)));
+	r_records.reserve(base + (size_t)MIN(voxel_count, (uint64_t)(1 << 22)));
+
+	int64_t bx = 0, by = 0, bz = 0;
+	for (uint64_t b = 0; b < block_count && !p_reader.has_error(); b++) {
+		bx += p_reader.get_zigzag();
+		by += p_reader.get_zigzag();
+		bz += p_reader.get_zigzag();
+		const int64_t limit = INT32_MAX / BLOCK_SIZE;
+		if (bx < -limit || bx > limit || by < -limit || by > limit || bz < -limit || bz > limit) {
+			p_reader.set_error(ERR_INVALID_DATA);
+			break;
+		}
+		const Vector3i origin((int32_t)bx * BLOCK_SIZE, (int32_t)by * BLOCK_SIZE, (int32_t)bz * BLOCK_SIZE);
+
+		const size_t block_begin = r_positions.size();
+		const uint64_t span_count = p_reader.get_varint();
+		uint64_t next_code = 0;
+		for (uint64_t s = 0; s < span_count && !p_reader.has_error(); s++) {
+			const uint64_t gap = p_reader.get_varint();
+			const uint64_t run = p_reader.get_varint() + 1;
+			const uint64_t start = next_code + MIN(gap, (uint64_t)CODES_PER_BLOCK);
+			const uint64_t end = start + MIN(run, (uint64_t)CODES_PER_BLOCK);
+			if (end > CODES_PER_BLOCK || r_positions.size() - base + (end - start) > voxel_count) {
+				p_reader.set_error(ERR_INVALID_DATA);
+				break;
+			}
+			for (uint32_t code = (uint32_t)start; code < (uint32_t)end; code++) {
+				uint32_t x, y, z;
+				morton_decode(code, x, y, z);
+				r_positions.push_back(Vector3i(origin.x + (int32_t)x, origin.y + (int32_t)y, origin.z + (int32_t)z));
+			}
+			next_code = end;
+		}
+
+		size_t filled = block_begin;
+		while (filled < r_positions.size() && !p_reader.has_error()) {
+			const uint64_t run = p_reader.get_varint() + 1;
+			const uint64_t index = p_reader.get_varint();
+			if (index >= palette_size || run > r_positions.size() - filled) {
+				p_reader.set_error(ERR_INVALID_DATA);
+				break;
+			}
+			r_records.insert(r_records.end(), (size_t)run, palette[index]);
+			filled += run;
+		}
+	}
+
+	if (!p_reader.has_error() && r_positions.size() - base != voxel_count) {
+		p_reader.set_error(ERR_INVALID_DATA);
+	}
+	if (p_reader.has_error()) {
+		r_positions.resize(base);
+		r_records.resize(MIN(r_records.size(), base));
+		return false;
+	}
+	return true;
+}
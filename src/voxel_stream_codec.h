@@ -0,0 +1,68 @@
+#ifndef VOXEL_STREAM_CODEC_H
+#define VOXEL_STREAM_CODEC_H
+
+#include "binary_stream.h"
+#include "voxel_chunk_data.h"
+#include <godot_cpp/variant/vector3i.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace godot {
+
+// Voxel section of save version 3 and later.
+// Voxels are grouped into BLOCK_SIZE^3 blocks and written in Z-order (Morton)
+// inside each block, so neighbours in space are neighbours in the stream:
+//   varint voxel_count
+//   varint palette_size, then palette_size 5-byte properties
+//     (blocktype, tx, ty, rot | vflip << 2, layer), most used first
+//   varint block_count, then per block:
+//     zigzag x, y, z of the block coordinate minus the previous block's
+//     varint span_count, then span_count pairs of varint (codes skipped, run length - 1)
+//       covering the occupied Morton codes in increasing order
+//     property runs, varint (run length - 1, palette index), until the block's voxels are covered
+// Blocks are self-contained apart from the palette and the previous block coordinate.
+class VoxelStreamCodec {
+public:
+	// First level_state_data["version"] saved with this encoding instead of per-voxel records
+	static const int FIRST_SAVE_VERSION = 3;
+
+	static const int BLOCK_SIZE = 32;
+	static const uint32_t CODES_PER_BLOCK = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+
+	// Interleaves the low 5 bits of x, y, z as ...z1 y1 x1 z0 y0 x0
+	static inline uint32_t morton_encode(uint32_t x, uint32_t y, uint32_t z) {
+		return _spread(x) | (_spread(y) << 1) | (_spread(z) << 2);
+	}
+	static inline void morton_decode(uint32_t p_code, uint32_t &r_x, uint32_t &r_y, uint32_t &r_z) {
+		r_x = _compact(p_code);
+		r_y = _compact(p_code >> 1);
+		r_z = _compact(p_code >> 2);
+	}
+
+	// Sorts a copy of the voxels into block / Morton order and writes them.
+	// When two voxels share a position only the first is kept, like chunk storage does.
+	static void encode(BinaryStreamCore &p_writer, const Vector3i *p_positions, const VoxelData *p_records, int64_t p_count);
+
+	// Appends the decoded voxels in stream order. Errors are left on the reader.
+	static bool decode(BinaryStreamCore &p_reader, std::vector<Vector3i> &r_positions, std::vector<VoxelData> &r_records);
+
+private:
+	static inline uint32_t _spread(uint32_t v) {
+		v &= BLOCK_SIZE - 1;
+		v = (v | (v << 8)) & 0x0300f00f;
+		v = (v | (v << 4)) & 0x030c30c3;
+		v = (v | (v << 2)) & 0x09249249;
+		return v;
+	}
+	static inline uint32_t _compact(uint32_t v) {
+		v &= 0x09249249;
+		v = (v ^ (v >> 2)) & 0x030c30c3;
+		v = (v ^ (v >> 4)) & 0x0300f00f;
+		v = (v ^ (v >> 8)) & 0xff0000ff;
+		return v & (BLOCK_SIZE - 1);
+	}
+};
+
+} // namespace godot
+
+#endif // VOXEL_STREAM_CODEC_H
@@ -0,0 +1,104 @@
+#include "wobble_cache.h"
+
+using namespace godot;
+
+WobbleCache::WobbleCache() {
+	total_entries = 0;
+	memory_limit = 64 * 1024 * 1024;
+	hits = 0;
+	misses = 0;
+}
+
+WobbleCache::BlockRef WobbleCache::_get_block_locked(const Vector3i &p_block_coord) {
+	auto it = blocks.find(p_block_coord);
+	if (it != blocks.end()) {
+		// Touch: move to the front of the LRU list
+		lru.splice(lru.begin(), lru, it->second.second);
+		return it->second.first;
+	}
+
+	BlockRef block = std::make_shared<Block>();
+	block->origin = p_block_coord * BLOCK_SIZE;
+	lru.push_front(p_block_coord);
+	blocks[p_block_coord] = std::make_pair(block, lru.begin());
+	return block;
+}
+
+void WobbleCache::get_blocks(const Vector3i &p_min_block, const Vector3i &p_max_block, std::vector<BlockRef> &r_blocks) {
+	r_blocks.clear();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (memory_limit == 0) {
+		return;
+	}
+	for (int z = p_min_block.z; z <= p_max_block.z; z++) {
+		for (int y = p_min_block.y; y <= p_max_block.y; y++) {
+			for (int x = p_min_block.x; x <= p_max_block.x; x++) {
+				r_blocks.push_back(_get_block_locked(Vector3i(x, y, z)));
+			}
+		}
+	}
+}
+
+void WobbleCache::_evict_locked() {
+	// Never evict the block that was just used, a mesher thread is filling it
+	while (total_entries * BYTES_PER_ENTRY > memory_limit && lru.size() > 1) {
+		const Vector3i victim = lru.back();
+		auto it = blocks.find(victim);
+		// Threads still holding the BlockRef keep it alive until they are done
+		total_entries -= MIN(total_entries, it->second.first->entry_count.load());
+		blocks.erase(it);
+		lru.pop_back();
+	}
+}
+
+void WobbleCache::note_inserted(const std::vector<BlockRef> &p_blocks, const std::vector<size_t> &p_counts) {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < p_blocks.size() && i < p_counts.size(); i++) {
+		if (p_counts[i] == 0) {
+			continue;
+		}
+		// A block evicted while it was being filled was already subtracted in full
+		auto it = blocks.find(block_coord(p_blocks[i]->origin));
+		if (it == blocks.end() || it->second.first != p_blocks[i]) {
+			continue;
+		}
+		total_entries += p_counts[i];
+	}
+	_evict_locked();
+}
+
+void WobbleCache::add_stats(uint64_t p_hits, uint64_t p_misses) {
+	hits += p_hits;
+	misses += p_misses;
+}
+
+void WobbleCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	blocks.clear();
+	lru.clear();
+	total_entries = 0;
+	hits = 0;
+	misses = 0;
+}
+
+void WobbleCache::set_memory_limit(size_t p_bytes) {
+	std::lock_guard<std::mutex> lock(mutex);
+	memory_limit = p_bytes;
+	if (memory_limit == 0) {
+		blocks.clear();
+		lru.clear();
+		total_entries = 0;
+		return;
+	}
+	_evict_locked();
+}
+
+size_t WobbleCache::get_block_count() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return blocks.size();
+}
+
+size_t WobbleCache::get_memory_usage() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return total_entries * BYTES_PER_ENTRY;
+}
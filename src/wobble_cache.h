@@ -0,0 +1,112 @@
+#ifndef WOBBLE_CACHE_H
+#define WOBBLE_CACHE_H
+
+#include <godot_cpp/variant/vector3.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <vector>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace godot {
+
+// World-space cache of raw wobble noise (the three noise values before scaling),
+// so lattice corners shared by neighbouring voxels, and whole areas that are
+// remeshed again after an edit, only pay for noise once.
+// Points are snapped to a 1/SUBDIV lattice and grouped into blocks of
+// BLOCK_SIZE^3 voxels, keyed by the block that holds the voxel being meshed.
+// Noise never changes for a given seed, so entries are only dropped when the
+// least recently used blocks go over the memory limit (or on clear()).
+// The mesher fetches the blocks under a chunk once (get_blocks) and reports
+// insertions and stats once per chunk, so the cache-wide mutex is taken a
+// couple of times per chunk rather than per voxel.
+class WobbleCache {
+public:
+	static const int BLOCK_SIZE = 16; // voxels per block side
+	static const int SUBDIV = 32; // lattice steps per voxel, shape vertices are on multiples of 1/32
+	static const int MARGIN = 2; // voxels around the block still addressable from inside it
+
+	// Rough heap cost of one cached point (unordered_map node + bucket)
+	static const size_t BYTES_PER_ENTRY = 48;
+
+	struct Block {
+		std::mutex mutex;
+		std::unordered_map<uint32_t, Vector3> noise; // lattice key -> (noise1, noise2, noise3)
+		std::atomic<size_t> entry_count{ 0 };
+		Vector3i origin; // world position of the block's first voxel
+	};
+	typedef std::shared_ptr<Block> BlockRef;
+
+private:
+	std::mutex mutex;
+	std::map<Vector3i, std::pair<BlockRef, std::list<Vector3i>::iterator>> blocks;
+	std::list<Vector3i> lru; // front = most recently used
+	size_t total_entries;
+	size_t memory_limit;
+
+	std::atomic<uint64_t> hits;
+	std::atomic<uint64_t> misses;
+
+	void _evict_locked();
+	BlockRef _get_block_locked(const Vector3i &p_block_coord);
+
+public:
+	WobbleCache();
+
+	// Block coordinate of the block holding voxel_pos
+	static inline Vector3i block_coord(const Vector3i &voxel_pos) {
+		return Vector3i(_floor_div(voxel_pos.x), _floor_div(voxel_pos.y), _floor_div(voxel_pos.z));
+	}
+
+	// Blocks p_min_block..p_max_block inclusive (x fastest, then y, then z),
+	// created on demand and marked as recently used. Left empty when the cache
+	// is disabled (memory limit of 0).
+	void get_blocks(const Vector3i &p_min_block, const Vector3i &p_max_block, std::vector<BlockRef> &r_blocks);
+
+	// Lattice key of a world position inside a block. False when the position is
+	// off the lattice or out of reach, in which case it is simply not cached.
+	static inline bool lattice_key(const Block &block, const Vector3 &world_pos, uint32_t &r_key) {
+		const int range = (BLOCK_SIZE + 2 * MARGIN) * SUBDIV;
+		const float fx = (world_pos.x - (float)(block.origin.x - MARGIN)) * (float)SUBDIV;
+		const float fy = (world_pos.y - (float)(block.origin.y - MARGIN)) * (float)SUBDIV;
+		const float fz = (world_pos.z - (float)(block.origin.z - MARGIN)) * (float)SUBDIV;
+		if (!(fx >= 0 && fy >= 0 && fz >= 0 && fx < range && fy < range && fz < range)) {
+			return false;
+		}
+		const uint32_t qx = (uint32_t)fx;
+		const uint32_t qy = (uint32_t)fy;
+		const uint32_t qz = (uint32_t)fz;
+		if ((float)qx != fx || (float)qy != fy || (float)qz != fz) {
+			return false;
+		}
+		r_key = qx | (qy << 10) | (qz << 20);
+		return true;
+	}
+
+	// Call after adding entries to blocks (with their mutexes released) to account
+	// for them and evict old blocks if needed. p_counts[i] belongs to p_blocks[i].
+	void note_inserted(const std::vector<BlockRef> &p_blocks, const std::vector<size_t> &p_counts);
+	void add_stats(uint64_t p_hits, uint64_t p_misses);
+
+	void clear();
+	void set_memory_limit(size_t p_bytes);
+	size_t get_memory_limit() const { return memory_limit; }
+
+	size_t get_block_count();
+	size_t get_memory_usage();
+	uint64_t get_hits() const { return hits.load(); }
+	uint64_t get_misses() const { return misses.load(); }
+
+private:
+	static inline int _floor_div(int a) {
+		return a >= 0 ? a / BLOCK_SIZE : -((-a + BLOCK_SIZE - 1) / BLOCK_SIZE);
+	}
+};
+
+} // namespace godot
+
+#endif // WOBBLE_CACHE_H